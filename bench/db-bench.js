@@ -16,6 +16,7 @@ const leveldown = require('../')
         , cacheSize        : argv.cacheSize       || 8
         , writeBufferSize  : argv.writeBufferSize || 4
         , valueSize        : argv.valueSize       || 100
+        , engine           : argv.engine          || 'lsm'
         , timingOutput     : argv.timingOutput
         , throughputOutput : argv.throughputOutput
       }
@@ -48,6 +49,7 @@ setTimeout(function () {
       , createIfMissing : true
       , cacheSize       : options.cacheSize << 20
       , writeBufferSize : options.writeBufferSize << 20
+      , engine          : options.engine
   }, function (err) {
 
   if (err)
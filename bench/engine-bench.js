@@ -0,0 +1,130 @@
+#!/usr/bin/env node
+
+// Runs the db-bench.js workload of random 16 character keys against an
+// LSM and a btree database, then reads random keys back from each, to
+// compare the two `engine` settings.
+
+const leveldown = require('../')
+    , crypto    = require('crypto')
+    , du        = require('du')
+
+    , argv      = require('optimist').argv
+
+    , options   = {
+          db               : argv.db              || '/tmp/engine-bench.db'
+        , engines          : argv.engine ? [ argv.engine ] : [ 'lsm', 'btree' ]
+        , num              : argv.num             || 1000000
+        , reads            : argv.reads           || argv.num || 1000000
+        , concurrency      : argv.concurrency     || 4
+        , cacheSize        : argv.cacheSize       || 8
+        , writeBufferSize  : argv.writeBufferSize || 4
+        , valueSize        : argv.valueSize       || 100
+      }
+
+    , keyTmpl = '0000000000000000'
+
+// make a 16 char padded key
+function makeKey () {
+  var r = Math.floor(Math.random() * options.num)
+    , k = keyTmpl + r
+  return k.substr(k.length - 16)
+}
+
+function openOptions (engine, create) {
+  return {
+      createIfMissing : create
+    , errorIfExists   : create
+    , engine          : engine
+    , cacheSize       : options.cacheSize << 20
+    , writeBufferSize : options.writeBufferSize << 20
+  }
+}
+
+// call `op` `count` times, `concurrency` at a time, then `callback`
+function run (count, op, callback) {
+  var started  = 0
+    , finished = 0
+
+  function next () {
+    if (started == count)
+      return
+    started++
+    op(function (err) {
+      if (err)
+        throw err
+      if (++finished == count)
+        return callback()
+      next()
+    })
+  }
+
+  for (var i = 0; i < options.concurrency; i++)
+    next()
+}
+
+function report (engine, phase, count, startTime) {
+  var ms = Date.now() - startTime
+  console.log(
+      engine + ':'
+    , count
+    , phase
+    , 'in'
+    , (ms / 1000) + 's,'
+    , Math.round(count / (ms / 1000)) + ' ops/s'
+  )
+}
+
+function bench (engine, callback) {
+  var location = options.db + '-' + engine
+    , value    = crypto.randomBytes(options.valueSize)
+
+  leveldown.destroy(location, function () {
+    var db        = leveldown(location)
+      , startTime
+
+    db.open(openOptions(engine, true), function (err) {
+      if (err)
+        throw err
+      startTime = Date.now()
+      run(options.num, function (cb) {
+        db.put(makeKey(), value, cb)
+      }, function () {
+        report(engine, 'random writes', options.num, startTime)
+        // reopen, so reads start from what is on disk
+        db.close(function (err) {
+          if (err)
+            throw err
+          db = leveldown(location)
+          db.open(openOptions(engine, false), function (err) {
+            if (err)
+              throw err
+            startTime = Date.now()
+            run(options.reads, function (cb) {
+              db.get(makeKey(), function (err) {
+                cb(err && !/NotFound/.test(err.message) ? err : null)
+              })
+            }, function () {
+              report(engine, 'random reads', options.reads, startTime)
+              db.close(function () {
+                du(location, function (err, size) {
+                  if (err)
+                    throw err
+                  console.log(
+                      engine + ': database size:'
+                    , Math.floor(size / 1024 / 1024) + 'M'
+                  )
+                  callback()
+                })
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+}
+
+;(function next (i) {
+  if (i < options.engines.length)
+    bench(options.engines[i], next.bind(null, i + 1))
+})(0)
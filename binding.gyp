@@ -3,6 +3,7 @@
       "target_name": "wiredtigerdown"
       , "include_dirs"  : [
             "<!(node -e \"require('nan')\")"
+          , "deps/wiredtiger-2.2.1/api/leveldb"
         ]
       , "link_settings": {
         "libraries": [ "../lib/libwiredtiger_leveldb.a"
@@ -11,12 +12,16 @@
       , "sources": [
             "src/batch.cc"
           , "src/batch_async.cc"
+          , "src/bulk_loader.cc"
+          , "src/bulk_loader_async.cc"
           , "src/database.cc"
           , "src/database_async.cc"
           , "src/iterator.cc"
           , "src/iterator_async.cc"
+          , "src/snapshot.cc"
           , "src/wiredtigerdown.cc"
           , "src/wiredtigerdown_async.cc"
+          , "src/worker_pool.cc"
         ]
     }]
 }
@@ -0,0 +1,152 @@
+// db.bulkLoad(source[, options], callback): loads sorted entries into an
+// empty database through db.bulkLoader(), see the README. `source` is an
+// Array of { key, value } entries, an iterator with a leveldown-style
+// next(callback), or a readable object-mode stream of { key, value }.
+// Entries are packed with encodeBatch() into Buffers of about
+// `options.bufferSize` bytes, one write() to the loader at a time.
+
+const encodeBatch = require('./encode-batch')
+    , DEFAULT_BUFFER_SIZE = 1024 * 1024
+
+function byteLength (thing) {
+  if (Buffer.isBuffer(thing))
+    return thing.length
+  return Buffer.byteLength(String(thing))
+}
+
+// Each pull function hands the entries of a source to
+// onEntry(key, value, next) one at a time, moving on when next() is
+// called, and calls onEnd(err) once the source runs out or either it or
+// next(err) reports an error.
+
+// calls iterator.next(callback) until it gives no entry
+function pullFromIterator (iterator, onEntry, onEnd) {
+  function pull () {
+    iterator.next(function (err, key, value) {
+      if (err || (key === undefined && value === undefined))
+        return onEnd(err)
+      onEntry(key, value, function (err) {
+        if (err)
+          return onEnd(err)
+        pull()
+      })
+    })
+  }
+  pull()
+}
+
+function pullFromArray (array, onEntry, onEnd) {
+  var i = 0
+  function pull () {
+    // loop rather than recurse while next() is called synchronously
+    while (i < array.length) {
+      var entry = array[i++]
+        , sync  = true
+        , more  = false
+      if (entry === null || typeof entry != 'object')
+        continue
+      onEntry(entry.key, entry.value, function (err) {
+        if (err)
+          return onEnd(err)
+        if (sync)
+          more = true
+        else
+          pull()
+      })
+      sync = false
+      if (!more)
+        return
+    }
+    onEnd()
+  }
+  pull()
+}
+
+function pullFromStream (stream, onEntry, onEnd) {
+  var ended = false
+  function end (err) {
+    if (ended)
+      return
+    ended = true
+    stream.removeListener('data', onData)
+    onEnd(err)
+  }
+  function onData (entry) {
+    stream.pause()
+    onEntry(entry.key, entry.value, function (err) {
+      if (err)
+        return end(err)
+      stream.resume()
+    })
+  }
+  stream.on('data', onData)
+  stream.on('error', end)
+  stream.on('end', function () { end() })
+}
+
+module.exports = function bulkLoad (source, options, callback) {
+  if (typeof options == 'function') {
+    callback = options
+    options  = {}
+  }
+  if (typeof callback != 'function')
+    throw new Error('bulkLoad() requires a callback argument')
+  options = options || {}
+
+  var pull
+  if (Array.isArray(source))
+    pull = pullFromArray
+  else if (source && typeof source.next == 'function')
+    pull = pullFromIterator
+  else if (source && typeof source.on == 'function')
+    pull = pullFromStream
+  else
+    return callback(new Error('bulkLoad() requires an Array, iterator or stream'))
+
+  var bufferSize = options.bufferSize > 0
+        ? options.bufferSize : DEFAULT_BUFFER_SIZE
+    , loader
+    , operations = []
+    , size       = 0
+
+  try {
+    loader = this.bulkLoader()
+  } catch (err) {
+    return callback(err)
+  }
+
+  function flush (next) {
+    var buffer
+    try {
+      buffer = encodeBatch(operations)
+    } catch (err) {
+      return next(err)
+    }
+    operations = []
+    size       = 0
+    loader.write(buffer, next)
+  }
+
+  function onEntry (key, value, next) {
+    operations.push({ type: 'put', key: key, value: value })
+    size += byteLength(key) + byteLength(value)
+    if (size < bufferSize)
+      return next()
+    flush(next)
+  }
+
+  // the loader is finished whatever happens: if the source fails part way
+  // the entries already written are kept, but a key out of order fails
+  // the whole load
+  function finish (error) {
+    loader.finish(function (err) {
+      callback(error || err || null)
+    })
+  }
+
+  pull(source, onEntry, function (err) {
+    if (err || operations.length === 0)
+      return finish(err)
+    flush(finish)
+  })
+}
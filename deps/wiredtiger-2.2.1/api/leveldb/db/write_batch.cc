@@ -35,7 +35,12 @@ void WriteBatch::Clear() {
 }
 
 Status WriteBatch::Iterate(Handler* handler) const {
-  Slice input(rep_);
+  return WriteBatchInternal::Iterate(Slice(rep_), handler);
+}
+
+Status WriteBatchInternal::Iterate(const Slice& contents,
+                                   WriteBatch::Handler* handler) {
+  Slice input(contents);
   if (input.size() < kHeader) {
     return Status::Corruption("malformed WriteBatch (too small)");
   }
@@ -67,7 +72,7 @@ Status WriteBatch::Iterate(Handler* handler) const {
         return Status::Corruption("unknown WriteBatch tag");
     }
   }
-  if (found != WriteBatchInternal::Count(this)) {
+  if (found != static_cast<int>(DecodeFixed32(contents.data() + 8))) {
     return Status::Corruption("WriteBatch has wrong count");
   } else {
     return Status::OK();
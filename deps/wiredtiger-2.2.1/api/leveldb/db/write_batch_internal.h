@@ -31,6 +31,10 @@ class WriteBatchInternal {
   static void SetContents(WriteBatch* batch, const Slice& contents);
 
   static void Append(WriteBatch* dst, const WriteBatch* src);
+
+  // As for WriteBatch::Iterate, over contents laid out like rep_ that
+  // need not belong to a WriteBatch.
+  static Status Iterate(const Slice& contents, WriteBatch::Handler* handler);
 };
 
 }  // namespace leveldb
@@ -5,10 +5,18 @@
  * See the file LICENSE for redistribution information.
  */
 #include "leveldb_wt.h"
+#include "db/write_batch_internal.h"
+#include <ctype.h>
 #include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
+#include <map>
 #include <sstream>
+#include <vector>
 
 using leveldb::Cache;
 using leveldb::FilterPolicy;
@@ -16,6 +24,7 @@ using leveldb::Iterator;
 using leveldb::Options;
 using leveldb::ReadOptions;
 using leveldb::WriteBatch;
+using leveldb::WriteBatchInternal;
 using leveldb::WriteOptions;
 using leveldb::Range;
 using leveldb::Slice;
@@ -28,11 +37,12 @@ class ReplayIterator;
 #endif
 
 #define	WT_URI	"table:data"
-#define	WT_CONN_CONFIG	"log=(enabled),checkpoint_sync=false,transaction_sync=none,session_max=256,"
-#define	WT_TABLE_CONFIG	"type=lsm,leaf_page_max=4KB,leaf_item_max=1KB,"
+#define	WT_CONN_CONFIG	"log=(enabled),checkpoint_sync=false,transaction_sync=none,"
+#define	WT_TABLE_CONFIG	"leaf_page_max=4KB,leaf_item_max=1KB,"
 
 /* Destructors required for interfaces. */
 leveldb::DB::~DB() {}
+leveldb::BulkLoader::~BulkLoader() {}
 Snapshot::~Snapshot() {}
 
 /* Iterators, from leveldb/table/iterator.cc */
@@ -146,8 +156,21 @@ Status DestroyDB(const std::string& name, const Options& options) {
   WT_SESSION *session;
   ret = conn->open_session(conn, NULL, NULL, &session);
   assert(ret == 0);
-  ret = session->drop(session, WT_URI, "force");
+  /* Drop the data table and every namespace's table. */
+  std::vector<std::string> tables;
+  WT_CURSOR *meta;
+  const char *key;
+  ret = session->open_cursor(session, "metadata:", NULL, NULL, &meta);
   assert(ret == 0);
+  while (meta->next(meta) == 0 && meta->get_key(meta, &key) == 0)
+	  if (strncmp(key, "table:", strlen("table:")) == 0)
+		  tables.push_back(key);
+  ret = meta->close(meta);
+  assert(ret == 0);
+  for (size_t i = 0; i < tables.size(); i++) {
+	  ret = session->drop(session, tables[i].c_str(), "force");
+	  assert(ret == 0);
+  }
   ret = conn->close(conn, NULL);
   assert(ret == 0);
   return Status::OK();
@@ -158,70 +181,397 @@ Status RepairDB(const std::string& dbname, const Options& options) {
 }
 }
 
-/* POSIX thread-local storage */
-template <class T>
-class ThreadLocal {
+/* WiredTiger implementations. */
+class DbImpl;
+
+/*
+ * Context for operations (including snapshots, write batches,
+ * transactions): a session, with a cursor on each table it has been used
+ * for.  Every table in the connection has a small id (see
+ * ConnectionImpl::tableId) indexing the cursors, which are opened the
+ * first time they are asked for and kept for as long as the session.
+ *
+ * Opening the session fails once the connection has session_max sessions
+ * open, so check status() before using a new context.
+ */
+class OperationContext {
 public:
-	static void cleanup(void *val) {
-		delete (T *)val;
+	OperationContext(WT_CONNECTION *conn) : session_(NULL) {
+		int ret = conn->open_session(conn, NULL, NULL, &session_);
+		// WiredTiger fails with WT_ERROR once every session the
+		// connection is configured for is in use.
+		if (ret != 0) {
+			session_ = NULL;
+			status_ = Status::IOError("cannot open a session",
+			    ret == WT_ERROR ?
+			    "session_max sessions are already open" :
+			    wiredtiger_strerror(ret));
+		}
 	}
 
-	ThreadLocal() {
-		int ret = pthread_key_create(&key_, cleanup);
-		assert(ret == 0);
+	~OperationContext() {
+		if (session_ != NULL) {
+			int ret = session_->close(session_, NULL);
+			assert(ret == 0);
+		}
 	}
 
-	~ThreadLocal() {
-		int ret = pthread_key_delete(key_);
-		assert(ret == 0);
+	Status status() const { return status_; }
+
+	// The cursor on "table" in *cursorp, opened if this is the first
+	// time it is asked for.
+	Status getCursor(int table, const std::string &uri, WT_CURSOR **cursorp) {
+		if ((size_t)table >= cursors_.size())
+			cursors_.resize(table + 1, NULL);
+		if (cursors_[table] == NULL) {
+			int ret = session_->open_cursor(
+			    session_, uri.c_str(), NULL, NULL, &cursors_[table]);
+			if (ret != 0) {
+				cursors_[table] = NULL;
+				return Status::IOError(
+				    "cannot open a cursor", wiredtiger_strerror(ret));
+			}
+		}
+		*cursorp = cursors_[table];
+		return Status::OK();
 	}
+	WT_SESSION *getSession() { return session_; }
 
-	T *get() {
-		return (T *)(pthread_getspecific(key_));
+	// Let go of the cursors' positions, ready for reuse.
+	void reset() {
+		for (size_t i = 0; i < cursors_.size(); i++)
+			if (cursors_[i] != NULL) {
+				int ret = cursors_[i]->reset(cursors_[i]);
+				assert(ret == 0);
+			}
 	}
 
-	void set(T *value) {
-		int ret = pthread_setspecific(key_, value);
-		assert(ret == 0);
+private:
+	WT_SESSION *session_;
+	std::vector<WT_CURSOR *> cursors_;
+	Status status_;
+};
+
+/*
+ * A bounded cache of contexts.  Every read, write and iterator checks a
+ * context out for as long as it needs a session and cursor nobody else
+ * will use, and hands it back when done, rather than opening a session
+ * and cursor each time.  Iterators may be stepped from a different thread
+ * each time, so contexts can't be tied to threads.
+ *
+ * The cache is a fixed array of slots claimed and filled with atomic
+ * compare-and-swap, so threads checking contexts in and out never block
+ * one another.  When every slot is empty a new context is opened, and a
+ * context handed back when every slot is full is closed, so at most
+ * "size" idle sessions are ever kept open.  Nothing limits the contexts
+ * checked out but the connection's session_max, so checking one out fails
+ * rather than waits once that many sessions are open: the contexts in use
+ * may belong to iterators that won't be handed back for a long time.
+ */
+class ContextPool {
+public:
+	ContextPool(WT_CONNECTION *conn, int size) : conn_(conn), size_(size > 0 ? size : 0), slots_(NULL) {
+		if (size_ > 0)
+			slots_ = new OperationContext *[size_]();
+	}
+	// Every context must have been handed back: the sessions are
+	// closed here, and must be closed before the connection.
+	~ContextPool() {
+		for (int i = 0; i < size_; i++)
+			delete slots_[i];
+		delete[] slots_;
+	}
+
+	Status get(OperationContext **ctxp) {
+		for (int i = 0; i < size_; i++) {
+			OperationContext *ctx = slots_[i];
+			if (ctx != NULL &&
+			    __sync_bool_compare_and_swap(&slots_[i], ctx, NULL)) {
+				*ctxp = ctx;
+				return Status::OK();
+			}
+		}
+		OperationContext *ctx = new OperationContext(conn_);
+		Status status = ctx->status();
+		if (!status.ok()) {
+			delete ctx;
+			ctx = NULL;
+		}
+		*ctxp = ctx;
+		return status;
+	}
+
+	void release(OperationContext *ctx) {
+		ctx->reset();
+		for (int i = 0; i < size_; i++)
+			if (slots_[i] == NULL &&
+			    __sync_bool_compare_and_swap(&slots_[i], NULL, ctx))
+				return;
+		delete ctx;
 	}
 
 private:
-	pthread_key_t key_;
+	WT_CONNECTION *conn_;
+	int size_;
+	OperationContext **slots_;
+
+	// No copying allowed
+	ContextPool(const ContextPool&);
+	void operator=(const ContextPool&);
 };
 
-/* WiredTiger implementations. */
-class DbImpl;
+/*
+ * Check a context out of a pool for the life of a scope, if given one,
+ * for work on one table.  Check status() before using it: the context or
+ * its cursor on the table may not have been available.
+ */
+class ScopedContext {
+public:
+	ScopedContext(ContextPool *pool, int table, const std::string &uri) : pool_(pool), context_(NULL), cursor_(NULL) {
+		if (pool_ == NULL)
+			return;
+		status_ = pool_->get(&context_);
+		if (status_.ok())
+			status_ = context_->getCursor(table, uri, &cursor_);
+	}
+	~ScopedContext() {
+		if (context_ != NULL)
+			pool_->release(context_);
+	}
 
-/* Context for operations (including snapshots, write batches, transactions) */
-class OperationContext {
+	Status status() const { return status_; }
+	WT_CURSOR *getCursor() { return cursor_; }
+	Status getCursor(int table, const std::string &uri, WT_CURSOR **cursorp) {
+		return context_->getCursor(table, uri, cursorp);
+	}
+	WT_SESSION *getSession() { return context_->getSession(); }
+
+private:
+	ContextPool *pool_;
+	OperationContext *context_;
+	WT_CURSOR *cursor_;
+	Status status_;
+
+	// No copying allowed
+	ScopedContext(const ScopedContext&);
+	void operator=(const ScopedContext&);
+};
+
+/*
+ * Writes WiredTiger's error messages to stderr, as its default handler
+ * does, except while capturing, when the last one is kept instead so that
+ * it can be returned in a Status.  Only capture while the handle using the
+ * handler is used by a single thread.
+ */
+class ErrorHandler : public WT_EVENT_HANDLER {
 public:
-	OperationContext(WT_CONNECTION *conn) {
-		int ret = conn->open_session(conn, NULL, NULL, &session_);
+	ErrorHandler() : capture_(false) {
+		handle_error = handleError;
+		handle_message = NULL;
+		handle_progress = NULL;
+		handle_close = NULL;
+	}
+
+	void capture(bool capture) {
+		capture_ = capture;
+		message_.clear();
+	}
+
+	// The message WiredTiger gave for error "ret", or failing that the
+	// description of "ret".
+	std::string describe(int ret) const {
+		return (message_.empty() ?
+		    std::string(wiredtiger_strerror(ret)) : message_);
+	}
+
+private:
+	bool capture_;
+	std::string message_;
+
+	static int handleError(WT_EVENT_HANDLER *handler,
+	    WT_SESSION *session, int error, const char *message) {
+		ErrorHandler *errors = static_cast<ErrorHandler *>(handler);
+		if (errors->capture_) {
+			// Drop the "[time][process:thread], " prefix.
+			const char *text = strstr(message, "], ");
+			errors->message_ = message[0] == '[' && text != NULL ?
+			    text + strlen("], ") : message;
+			return (0);
+		}
+		return (fprintf(stderr, "%s\n", message) >= 0 &&
+		    fflush(stderr) == 0 ? 0 : EIO);
+	}
+};
+
+/*
+ * What every database handle opened on a WiredTiger connection shares: the
+ * connection itself and the cache of contexts.  The handle WiredTigerDB::Open
+ * returns and each namespace opened through it hold a reference, and the
+ * connection is closed along with the last of them.
+ */
+class ConnectionImpl {
+public:
+	ConnectionImpl(WT_CONNECTION *conn, ErrorHandler *errors, const std::string &home, const leveldb::WiredTigerOptions &wt_options) : conn_(conn), errors_(errors), home_(home), statistics_(wt_options.statistics != "none"), contexts_(new ContextPool(conn, wt_options.session_cache_size)), refs_(1) {
+		int ret = pthread_mutex_init(&tablesLock_, NULL);
+		assert(ret == 0);
+	}
+
+	void ref() { (void)__sync_add_and_fetch(&refs_, 1); }
+	void unref() {
+		if (__sync_sub_and_fetch(&refs_, 1) == 0)
+			delete this;
+	}
+
+	// The id OperationContext keeps the cursor on a table under, the
+	// same for every handle on the table.
+	int tableId(const std::string &uri) {
+		(void)pthread_mutex_lock(&tablesLock_);
+		std::map<std::string, int>::iterator it = tables_.find(uri);
+		int id = it != tables_.end() ? it->second : (int)tables_.size();
+		if (it == tables_.end())
+			tables_[uri] = id;
+		(void)pthread_mutex_unlock(&tablesLock_);
+		return id;
+	}
+
+	WT_CONNECTION *getConnection() { return conn_; }
+	const std::string &getHome() { return home_; }
+	bool hasStatistics() { return statistics_; }
+	ContextPool *getContexts() { return contexts_; }
+
+private:
+	WT_CONNECTION *conn_;
+	ErrorHandler *errors_;
+	std::string home_;
+	bool statistics_;
+	ContextPool *contexts_;
+	int refs_;
+	pthread_mutex_t tablesLock_;
+	std::map<std::string, int> tables_;
+
+	// Deleted by the last unref, the sessions are closed before the
+	// connection.
+	~ConnectionImpl() {
+		delete contexts_;
+		int ret = conn_->close(conn_, NULL);
 		assert(ret == 0);
-		ret = session_->open_cursor(
-		    session_, WT_URI, NULL, NULL, &cursor_);
+		delete errors_;
+		ret = pthread_mutex_destroy(&tablesLock_);
 		assert(ret == 0);
 	}
 
-	~OperationContext() {
-#ifdef WANT_SHUTDOWN_RACES
-		int ret = session_->close(session_, NULL);
+	// No copying allowed
+	ConnectionImpl(const ConnectionImpl&);
+	void operator=(const ConnectionImpl&);
+};
+
+/*
+ * A snapshot is a session of its own running a snapshot isolation
+ * transaction, so every read made through it sees the database as it was
+ * when the snapshot was taken.  WiredTiger sessions are single threaded,
+ * so reads from different threads through one snapshot are serialized on
+ * its mutex.
+ */
+class SnapshotImpl : public Snapshot {
+public:
+	SnapshotImpl(WT_CONNECTION *conn) : Snapshot(), context_(conn) {
+		WT_SESSION *session = context_.getSession();
+		int ret;
+		if (session != NULL) {
+			ret = session->begin_transaction(
+			    session, "isolation=snapshot");
+			assert(ret == 0);
+		}
+		ret = pthread_mutex_init(&mutex_, NULL);
+		assert(ret == 0);
+	}
+	// Nothing was written, closing the context's session rolls back
+	// the transaction and closes any cursors.
+	virtual ~SnapshotImpl() {
+		int ret = pthread_mutex_destroy(&mutex_);
 		assert(ret == 0);
-#endif
 	}
 
-	WT_CURSOR *getCursor() { return cursor_; }
-	WT_SESSION *getSession() { return session_; }
+	// Whether the snapshot's session could be opened.
+	Status status() const { return context_.status(); }
+
+	// The snapshot covers every table in the connection, so it can be
+	// used to read from any namespace.
+	Status getCursor(int table, const std::string &uri, WT_CURSOR **cursorp) {
+		return context_.getCursor(table, uri, cursorp);
+	}
+	WT_SESSION *getSession() { return context_.getSession(); }
+	void lock() { (void)pthread_mutex_lock(&mutex_); }
+	void unlock() { (void)pthread_mutex_unlock(&mutex_); }
 
 private:
-	WT_SESSION *session_;
-	WT_CURSOR *cursor_;
+	OperationContext context_;
+	pthread_mutex_t mutex_;
+
+	// No copying allowed
+	SnapshotImpl(const SnapshotImpl&);
+	void operator=(const SnapshotImpl&);
+};
+
+/* Hold a snapshot's mutex for the life of a scope, if there is one. */
+class SnapshotLock {
+public:
+	SnapshotLock(SnapshotImpl *snapshot) : snapshot_(snapshot) {
+		if (snapshot_ != NULL)
+			snapshot_->lock();
+	}
+	~SnapshotLock() {
+		if (snapshot_ != NULL)
+			snapshot_->unlock();
+	}
+
+private:
+	SnapshotImpl *snapshot_;
+};
+
+/*
+ * What GetApproximateSizes knows about a file holding table data: its size
+ * on disk and, in order, the first key, a sample of keys picked at random
+ * and the last key.
+ */
+struct DataFile {
+	std::string uri;
+	std::vector<std::string> keys;
+	uint64_t size;
+	bool chunk;		// A chunk of an LSM tree
+	bool written;		// An LSM chunk that won't change again
 };
 
+#define	WT_SIZE_SAMPLES	32
+
 class IteratorImpl : public Iterator {
 public:
-	IteratorImpl(WT_CURSOR *cursor, DbImpl *db, const ReadOptions &options) : cursor_(cursor), status_(Status::OK()), valid_(false) {}
-	virtual ~IteratorImpl() {}
+	// Iterate over a table using a context checked out of "pool",
+	// returned when the iterator is deleted.  If no context is to be
+	// had the iterator is never Valid() and status() says why.
+	IteratorImpl(ContextPool *pool, int table, const std::string &uri, const ReadOptions &options, const leveldb::IteratorBounds &bounds) : cursor_(NULL), pool_(pool), context_(NULL), snapshot_(NULL), status_(Status::OK()), valid_(false) {
+		status_ = pool_->get(&context_);
+		if (status_.ok())
+			status_ = context_->getCursor(table, uri, &cursor_);
+		setBounds(bounds);
+	}
+	// An iterator that failed to open its cursor.
+	IteratorImpl(const Status &status) : cursor_(NULL), pool_(NULL), context_(NULL), snapshot_(NULL), status_(status), valid_(false) {
+		setBounds(leveldb::IteratorBounds());
+	}
+	// Iterate using a cursor of our own in a snapshot's session.
+	IteratorImpl(WT_CURSOR *cursor, const ReadOptions &options, const leveldb::IteratorBounds &bounds) : cursor_(cursor), pool_(NULL), context_(NULL), snapshot_((SnapshotImpl *)options.snapshot), status_(Status::OK()), valid_(false) {
+		setBounds(bounds);
+	}
+	virtual ~IteratorImpl() {
+		if (context_ != NULL)
+			pool_->release(context_);
+		if (snapshot_ != NULL && cursor_ != NULL) {
+			SnapshotLock l(snapshot_);
+			int ret = cursor_->close(cursor_);
+			assert(ret == 0);
+		}
+	}
 
 	// An iterator is either positioned at a key/value pair, or
 	// not valid.  This method returns true iff the iterator is valid.
@@ -251,28 +601,48 @@ public:
 
 private:
 	WT_CURSOR *cursor_;
+	ContextPool *pool_;
+	OperationContext *context_;
+	SnapshotImpl *snapshot_;
 	Slice key_, value_;
 	Status status_;
 	bool valid_;
 
+	// Bounds, see leveldb::IteratorBounds.  Keys in the range all
+	// start with the "prefix_" bytes the two bounds have in common,
+	// so those bytes are checked once rather than against each bound.
+	std::string lower_, upper_;
+	bool has_lower_, has_upper_;
+	bool lower_inclusive_, upper_inclusive_;
+	size_t prefix_;
+	int limit_, count_;
+
+	void setBounds(const leveldb::IteratorBounds &bounds);
+	bool inBounds(const WT_ITEM &key) const;
+	int seekBound(const std::string &bound, bool inclusive, bool forward);
+	void positioned(int ret);
+
 	// No copying allowed
 	IteratorImpl(const IteratorImpl&);
 	void operator=(const IteratorImpl&);
 };
 
-class SnapshotImpl : public Snapshot {
-public:
-	SnapshotImpl(DbImpl *db) : Snapshot() {}
-	virtual ~SnapshotImpl() {}
-};
 
-class DbImpl : public leveldb::DB {
+
+/*
+ * A handle on one table: "table:data" for the handle WiredTigerDB::Open
+ * returns, "table:<name>" for a namespace.
+ */
+class DbImpl : public leveldb::WiredTigerDB {
 public:
-	DbImpl(WT_CONNECTION *conn) : DB(), conn_(conn), context_(new ThreadLocal<OperationContext>) {}
+	DbImpl(ConnectionImpl *connection, const std::string &uri) : WiredTigerDB(), connection_(connection), conn_(connection->getConnection()), home_(connection->getHome()), statistics_(connection->hasStatistics()), contexts_(connection->getContexts()), uri_(uri), table_(connection->tableId(uri)), bulkLoading_(0) {
+		int ret = pthread_mutex_init(&chunksLock_, NULL);
+		assert(ret == 0);
+	}
 	virtual ~DbImpl() {
-		delete context_;
-		int ret = conn_->close(conn_, NULL);
+		int ret = pthread_mutex_destroy(&chunksLock_);
 		assert(ret == 0);
+		connection_->unref();
 	}
 
 	virtual Status Put(const WriteOptions& options,
@@ -283,9 +653,30 @@ public:
 
 	virtual Status Write(const WriteOptions& options, WriteBatch* updates);
 
+	virtual Status Write(const WriteOptions& options, const Slice& contents);
+
+	virtual Status Write(const WriteOptions& options,
+		     const std::vector<std::pair<WiredTigerDB*, WriteBatch*> >& updates);
+
+	virtual Status OpenNamespace(const Options& options,
+		     const leveldb::WiredTigerOptions& wt_options,
+		     const std::string& name, WiredTigerDB** dbptr);
+
+	virtual Status DeleteRange(const WriteOptions& options,
+		     const Slice* begin, bool include_begin,
+		     const Slice* end, bool include_end);
+
+	virtual Status NewBulkLoader(leveldb::BulkLoader** loader);
+
 	virtual Status Get(const ReadOptions& options,
 		     const Slice& key, std::string* value);
 
+	virtual Status Get(const ReadOptions& options,
+		     const Slice& key, char** value, size_t* size);
+
+	virtual Status Get(const ReadOptions& options,
+		     const std::vector<Slice>& keys, char** values, size_t* sizes);
+
 #ifdef HAVE_HYPERLEVELDB
 	virtual Status LiveBackup(const Slice& name) { return Status::NotSupported("sorry!"); }
 	virtual void GetReplayTimestamp(std::string* timestamp) {}
@@ -299,6 +690,9 @@ public:
 
 	virtual Iterator* NewIterator(const ReadOptions& options);
 
+	virtual Iterator* NewIterator(const ReadOptions& options,
+		     const leveldb::IteratorBounds& bounds);
+
 	virtual const Snapshot* GetSnapshot();
 
 	virtual void ReleaseSnapshot(const Snapshot* snapshot);
@@ -310,36 +704,195 @@ public:
 
 	virtual void CompactRange(const Slice* begin, const Slice* end);
 
+	virtual Status CompactRange(const Slice* begin, const Slice* end,
+		     leveldb::CompactionStats* stats);
+
 	virtual void SuspendCompactions();
 	
 	virtual void ResumeCompactions();
 
 private:
+	ConnectionImpl *connection_;
 	WT_CONNECTION *conn_;
-	ThreadLocal<OperationContext> *context_;
+	std::string home_;
+	bool statistics_;
+	ContextPool *contexts_;
 
-	OperationContext *getContext() {
-		OperationContext *ctx = context_->get();
-		if (ctx == NULL) {
-			ctx = new OperationContext(conn_);
-			context_->set(ctx);
-		}
-		return (ctx);
-	}
+	// The table, and its id in the connection's contexts.
+	std::string uri_;
+	int table_;
+
+	// Set while a BulkLoader is running, only one may run at a time.
+	int bulkLoading_;
+
+	// LSM chunks that have been written out never change again, so
+	// what GetApproximateSizes learns about them is kept, by chunk id.
+	pthread_mutex_t chunksLock_;
+	std::map<uint32_t, DataFile> chunks_;
 
-	WT_CURSOR *getCursor() { return getContext()->getCursor(); }
+	std::string getSource(WT_CURSOR *meta);
+	void getDataFiles(WT_SESSION *session, std::vector<DataFile> *files);
+	bool readDataFile(
+	    WT_SESSION *session, const std::string &uri, DataFile *file);
 
 	// No copying allowed
 	DbImpl(const DbImpl&);
 	void operator=(const DbImpl&);
 };
 
+leveldb::CompactionStats::CompactionStats()
+    : files_before(0),
+      files_after(0),
+      bytes_before(0),
+      bytes_after(0),
+      files_compacted(0),
+      merged(false)
+{
+}
+
+leveldb::IteratorBounds::IteratorBounds()
+    : lower(NULL),
+      lower_inclusive(false),
+      upper(NULL),
+      upper_inclusive(false),
+      limit(-1)
+{
+}
+
+// Names that go into WiredTiger configuration strings, URIs and file
+// names are kept to characters that are safe in all of them.
+static bool
+validName(const std::string &name)
+{
+	if (name.empty())
+		return (false);
+	for (size_t i = 0; i < name.size(); i++)
+		if (!isalnum((unsigned char)name[i]) &&
+		    name[i] != '_' && name[i] != '-')
+			return (false);
+	return (true);
+}
+
+static bool
+validTableType(const std::string &table_type)
+{
+	return (table_type == "lsm" || table_type == "btree");
+}
+
+// Build the configuration for a table of type "table_type" from the
+// settings in "options", followed by "table_config".  A btree has no
+// chunks or Bloom filters, so write_buffer_size and filter_policy only
+// apply to LSM trees.
+static std::string
+tableConfig(const Options &options,
+    const std::string &table_type, const std::string &table_config)
+{
+	std::stringstream s_table;
+	s_table << WT_TABLE_CONFIG;
+	s_table << "internal_page_max=" << options.block_size << ",";
+	s_table << "leaf_page_max=" << options.block_size << ",";
+	if (options.compression == leveldb::kSnappyCompression)
+		s_table << "block_compressor=snappy,";
+	if (table_type == "btree")
+		s_table << "type=file,";
+	else {
+		s_table << "type=lsm,lsm=(";
+		s_table << "chunk_size=" << options.write_buffer_size << ",";
+		if (options.filter_policy) {
+			int bits = ((FilterPolicyImpl *)
+			    options.filter_policy)->bits_per_key_;
+			s_table << "bloom_bit_count=" << bits << ",";
+			// Approximate the optimal number of hashes
+			s_table << "bloom_hash_count=" << (int)(0.6 * bits) << ",";
+		}
+		s_table << "),";
+	}
+	// Settings passed through override those above.
+	s_table << table_config;
+	return s_table.str();
+}
+
+// Create the table "uri" with "config", or if "create" isn't set, check
+// that it exists.  WT_SESSION::create checks "config" either way, and
+// leaves a table that exists as it was created.
+static Status
+createTable(WT_CONNECTION *conn,
+    const std::string &uri, const std::string &config, bool create)
+{
+	ErrorHandler errors;
+	WT_SESSION *session;
+	int ret = conn->open_session(conn, &errors, NULL, &session);
+	if (ret != 0)
+		return Status::IOError(wiredtiger_strerror(ret));
+	errors.capture(true);
+	if (!create) {
+		WT_CURSOR *cursor;
+		if ((ret = session->open_cursor(
+		    session, uri.c_str(), NULL, NULL, &cursor)) == 0)
+			ret = cursor->close(cursor);
+	}
+	if (ret == 0)
+		ret = session->create(session, uri.c_str(), config.c_str());
+	int t_ret = session->close(session, NULL);
+	if (ret == 0)
+		ret = t_ret;
+	if (ret == ENOENT)
+		return Status::NotFound(Slice(uri), "does not exist");
+	if (ret == EINVAL)
+		return Status::InvalidArgument(errors.describe(ret));
+	if (ret != 0)
+		return Status::IOError(errors.describe(ret));
+	return Status::OK();
+}
+
+leveldb::WiredTigerOptions::WiredTigerOptions()
+    : session_cache_size(32),
+      session_max(256),
+      statistics("fast"),
+      table_type("lsm"),
+      connection_config(),
+      table_config(),
+      shared_cache(),
+      shared_cache_size(0),
+      shared_cache_reserve(0)
+{
+}
+
 Status
 leveldb::DB::Open(const Options &options, const std::string &name, leveldb::DB **dbptr)
 {
+	WiredTigerDB *db;
+	Status status =
+	    WiredTigerDB::Open(options, WiredTigerOptions(), name, &db);
+	if (status.ok())
+		*dbptr = db;
+	return status;
+}
+
+Status
+leveldb::WiredTigerDB::Open(const Options &options,
+    const WiredTigerOptions &wt_options, const std::string &name,
+    leveldb::WiredTigerDB **dbptr)
+{
+	if (wt_options.session_max < 1)
+		return Status::InvalidArgument(Slice("session_max must be positive"));
+	if (wt_options.statistics != "none" &&
+	    wt_options.statistics != "fast" && wt_options.statistics != "all")
+		return Status::InvalidArgument(
+		    Slice("statistics must be none, fast or all"));
+	if (!validTableType(wt_options.table_type))
+		return Status::InvalidArgument(
+		    Slice("table_type must be lsm or btree"));
+	if (!wt_options.shared_cache.empty() &&
+	    !validName(wt_options.shared_cache))
+		return Status::InvalidArgument(Slice(
+		    "shared_cache names are letters, digits, '_' and '-'"));
+
 	// Build the wiredtiger_open config.
 	std::stringstream s_conn;
 	s_conn << WT_CONN_CONFIG;
+	s_conn << "session_max=" << wt_options.session_max << ",";
+	s_conn << "statistics=(" << wt_options.statistics << "),";
 	if (options.create_if_missing) {
 		(void)mkdir(name.c_str(), 0777);
 		s_conn << "create,";
@@ -348,88 +901,182 @@ leveldb::DB::Open(const Options &options, const std::string &name, leveldb::DB *
 		s_conn << "exclusive,";
 	if (options.compression == kSnappyCompression)
 		s_conn << "extensions=[libwiredtiger_snappy.so],";
-	size_t cache_size = 25 * options.write_buffer_size;
-	if (options.block_cache)
-		cache_size += ((CacheImpl *)options.block_cache)->capacity_;
-	s_conn << "cache_size=" << cache_size << ",";
+	if (wt_options.shared_cache.empty()) {
+		size_t cache_size = 25 * options.write_buffer_size;
+		if (options.block_cache)
+			cache_size +=
+			    ((CacheImpl *)options.block_cache)->capacity_;
+		s_conn << "cache_size=" << cache_size << ",";
+	} else {
+		// WiredTiger refuses cache_size along with shared_cache, and
+		// picks its own defaults for the pool settings left at 0.
+		s_conn << "shared_cache=(name=" << wt_options.shared_cache;
+		if (wt_options.shared_cache_size != 0)
+			s_conn << ",size=" << wt_options.shared_cache_size;
+		if (wt_options.shared_cache_reserve != 0)
+			s_conn << ",reserve=" << wt_options.shared_cache_reserve;
+		s_conn << "),";
+	}
+	// Settings passed through override those above.
+	s_conn << wt_options.connection_config;
 	std::string conn_config = s_conn.str();
 
+	// The connection keeps the handler for its sessions, so it lives as
+	// long as the connection does.
+	ErrorHandler *errors = new ErrorHandler();
+	errors->capture(true);
 	WT_CONNECTION *conn;
-	int ret = ::wiredtiger_open(name.c_str(), NULL, conn_config.c_str(), &conn);
-	if (ret == ENOENT)
-		return Status::NotFound(Slice("Database does not exist."));
-	if (ret == EBUSY)
-		return Status::NotFound(Slice("Database already exists."));
-	assert(ret == 0);
-
-	if (options.create_if_missing) {
-		std::stringstream s_table;
-		s_table << WT_TABLE_CONFIG;
-		s_table << "internal_page_max=" << options.block_size << ",";
-		s_table << "leaf_page_max=" << options.block_size << ",";
-		if (options.compression == kSnappyCompression)
-			s_table << "block_compressor=snappy,";
-		s_table << "lsm=(";
-		s_table << "chunk_size=" << options.write_buffer_size << ",";
-		if (options.filter_policy) {
-			int bits = ((FilterPolicyImpl *)options.filter_policy)->bits_per_key_;
-			s_table << "bloom_bit_count=" << bits << ",";
-			// Approximate the optimal number of hashes
-			s_table << "bloom_hash_count=" << (int)(0.6 * bits) << ",";
-		}
-		s_table << "),";
-		WT_SESSION *session;
-		std::string table_config = s_table.str();
-		ret = conn->open_session(conn, NULL, NULL, &session);
-		assert(ret == 0);
-		ret = session->create(session, WT_URI, table_config.c_str());
-		assert(ret == 0);
-		ret = session->close(session, NULL);
-		assert(ret == 0);
+	int ret = ::wiredtiger_open(
+	    name.c_str(), errors, conn_config.c_str(), &conn);
+	if (ret != 0) {
+		std::string message = errors->describe(ret);
+		delete errors;
+		if (ret == ENOENT)
+			return Status::NotFound(
+			    Slice("Database does not exist."));
+		if (ret == EBUSY)
+			return Status::NotFound(
+			    Slice("Database already exists."));
+		if (ret == EINVAL)
+			return Status::InvalidArgument(message);
+		return Status::IOError(message);
 	}
+	errors->capture(false);
+
+	std::string table_config = tableConfig(
+	    options, wt_options.table_type, wt_options.table_config);
+	Status status = createTable(
+	    conn, WT_URI, table_config, options.create_if_missing);
+	if (!status.ok()) {
+		(void)conn->close(conn, NULL);
+		delete errors;
+		return status;
+	}
+
+	*dbptr = new DbImpl(
+	    new ConnectionImpl(conn, errors, name, wt_options), WT_URI);
+	return Status::OK();
+}
 
-	*dbptr = new DbImpl(conn);
+
+// Open a handle on the table for namespace "name", creating it with the
+// settings in "options" and the table settings in "wt_options" if
+// create_if_missing is set.  An existing table keeps the type and
+// settings it was created with.
+Status
+DbImpl::OpenNamespace(const Options& options,
+    const leveldb::WiredTigerOptions& wt_options, const std::string& name,
+    leveldb::WiredTigerDB** dbptr)
+{
+	// Namespaces are tables named after them, "table:data" is the
+	// database's own.
+	if (!validName(name) || name == "data")
+		return Status::InvalidArgument(
+		    "namespace names are letters, digits, '_' and '-', "
+		    "and not \"data\"");
+	if (!validTableType(wt_options.table_type))
+		return Status::InvalidArgument(
+		    "table_type must be lsm or btree");
+
+	std::string uri = "table:" + name;
+	std::string table_config = tableConfig(
+	    options, wt_options.table_type, wt_options.table_config);
+	Status status = createTable(
+	    conn_, uri, table_config, options.create_if_missing);
+	if (status.IsNotFound())
+		return Status::NotFound("namespace does not exist");
+	if (!status.ok())
+		return status;
+
+	connection_->ref();
+	*dbptr = new DbImpl(connection_, uri);
 	return Status::OK();
 }
 
+// The connection never syncs the log, so writes with WriteOptions::sync
+// set run in a transaction that does, and don't return until their log
+// record is on disk.  Sync commits arriving together share an fsync.
+// Writes of more than one entry ("atomic") always run in a transaction,
+// which applies them all or none and writes them as one log record.
+// Anything else is left to WiredTiger's auto-commit.
+static int
+beginWrite(WT_SESSION *session, const WriteOptions& options, bool atomic)
+{
+	if (options.sync)
+		return (session->begin_transaction(session, "sync=true"));
+	if (atomic)
+		return (session->begin_transaction(session, NULL));
+	return (0);
+}
+
+// Finish a write begun with beginWrite, rolling it back if "ret" is an
+// error.  A WT_DEADLOCK return means the caller should try again.
+static int
+endWrite(WT_SESSION *session,
+    const WriteOptions& options, bool atomic, int ret)
+{
+	if (!options.sync && !atomic)
+		return (ret);
+	if (ret == 0)
+		return (session->commit_transaction(session, NULL));
+	(void)session->rollback_transaction(session, NULL);
+	return (ret);
+}
+
 // Set the database entry for "key" to "value".  Returns OK on success,
 // and a non-OK status on error.
-// Note: consider setting options.sync = true.
 Status
 DbImpl::Put(const WriteOptions& options,
 	     const Slice& key, const Slice& value)
 {
-	WT_CURSOR *cursor = getCursor();
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	WT_CURSOR *cursor = context.getCursor();
 	WT_ITEM item;
+	int ret;
 
-	item.data = key.data();
-	item.size = key.size();
-	cursor->set_key(cursor, &item);
-	item.data = value.data();
-	item.size = value.size();
-	cursor->set_value(cursor, &item);
-	int ret = cursor->insert(cursor);
-	assert(ret == 0);
+	do {
+		if ((ret = beginWrite(session, options, false)) != 0)
+			break;
+		item.data = key.data();
+		item.size = key.size();
+		cursor->set_key(cursor, &item);
+		item.data = value.data();
+		item.size = value.size();
+		cursor->set_value(cursor, &item);
+		ret = endWrite(session, options, false, cursor->insert(cursor));
+	} while (ret == WT_DEADLOCK);
+	if (ret != 0)
+		return Status::IOError(wiredtiger_strerror(ret));
 	return Status::OK();
 }
 
 // Remove the database entry (if any) for "key".  Returns OK on
 // success, and a non-OK status on error.  It is not an error if "key"
 // did not exist in the database.
-// Note: consider setting options.sync = true.
 Status
 DbImpl::Delete(const WriteOptions& options, const Slice& key)
 {
-	WT_CURSOR *cursor = getCursor();
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	WT_CURSOR *cursor = context.getCursor();
 	WT_ITEM item;
+	int ret;
 
-	item.data = key.data();
-	item.size = key.size();
-	cursor->set_key(cursor, &item);
-	int ret = cursor->remove(cursor);
-	assert(ret == 0);
-	ret = cursor->reset(cursor);
-	assert(ret == 0);
+	do {
+		if ((ret = beginWrite(session, options, false)) != 0)
+			break;
+		item.data = key.data();
+		item.size = key.size();
+		cursor->set_key(cursor, &item);
+		ret = endWrite(session, options, false, cursor->remove(cursor));
+	} while (ret == WT_DEADLOCK);
+	if (ret != 0)
+		return Status::IOError(wiredtiger_strerror(ret));
 	return Status::OK();
 }
 
@@ -440,9 +1087,13 @@ public:
 	virtual ~WriteBatchHandler() {}
 	int getStatus() { return status_; }
 
+	// Once an update fails the transaction is rolled back, so the
+	// rest of the batch is skipped.
 	virtual void Put(const Slice& key, const Slice& value) {
 		WT_ITEM item;
 
+		if (status_ != 0)
+			return;
 		item.data = key.data();
 		item.size = key.size();
 		cursor_->set_key(cursor_, &item);
@@ -450,17 +1101,19 @@ public:
 		item.size = value.size();
 		cursor_->set_value(cursor_, &item);
 		int ret = cursor_->insert(cursor_);
-		if (ret != 0 && status_ == 0)
+		if (ret != 0)
 			status_ = ret;
 	}
 	virtual void Delete(const Slice& key) {
 		WT_ITEM item;
 
+		if (status_ != 0)
+			return;
 		item.data = key.data();
 		item.size = key.size();
 		cursor_->set_key(cursor_, &item);
 		int ret = cursor_->remove(cursor_);
-		if (ret != 0 && status_ == 0)
+		if (ret != 0)
 			status_ = ret;
 	}
 
@@ -471,19 +1124,334 @@ private:
 
 // Apply the specified updates to the database.
 // Returns OK on success, non-OK on failure.
-// Note: consider setting options.sync = true.
 Status
 DbImpl::Write(const WriteOptions& options, WriteBatch* updates)
 {
-	WT_CURSOR *cursor = getCursor();
-	WriteBatchHandler handler(cursor);
-	Status status = updates->Iterate(&handler);
-	assert(handler.getStatus() == 0);
-	int ret = cursor->reset(cursor);
-	assert(ret == 0);
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	Status status;
+	int ret;
+
+	do {
+		if ((ret = beginWrite(session, options, true)) != 0)
+			break;
+		WriteBatchHandler handler(context.getCursor());
+		status = updates->Iterate(&handler);
+		// Don't commit part of a batch that turned out to be corrupt.
+		if ((ret = handler.getStatus()) == 0 && !status.ok())
+			ret = EINVAL;
+		ret = endWrite(session, options, true, ret);
+	} while (ret == WT_DEADLOCK);
+	if (ret != 0 && status.ok())
+		return Status::IOError(wiredtiger_strerror(ret));
+	return status;
+}
+
+// Apply batches of updates to several tables in the connection, all in
+// one transaction: a context has a cursor for each table.
+Status
+DbImpl::Write(const WriteOptions& options,
+    const std::vector<std::pair<WiredTigerDB*, WriteBatch*> >& updates)
+{
+	for (size_t i = 0; i < updates.size(); i++)
+		if (((DbImpl *)updates[i].first)->connection_ != connection_)
+			return Status::InvalidArgument(
+			    "batch spans more than one database");
+
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	Status status;
+	int ret;
+
+	do {
+		if ((ret = beginWrite(session, options, true)) != 0)
+			break;
+		for (size_t i = 0; i < updates.size() && ret == 0; i++) {
+			DbImpl *db = (DbImpl *)updates[i].first;
+			WT_CURSOR *cursor;
+			status = context.getCursor(db->table_, db->uri_, &cursor);
+			if (!status.ok()) {
+				ret = EIO;
+				break;
+			}
+			WriteBatchHandler handler(cursor);
+			status = updates[i].second->Iterate(&handler);
+			if ((ret = handler.getStatus()) == 0 && !status.ok())
+				ret = EINVAL;
+		}
+		ret = endWrite(session, options, true, ret);
+	} while (ret == WT_DEADLOCK);
+	if (ret != 0 && status.ok())
+		return Status::IOError(wiredtiger_strerror(ret));
+	return status;
+}
+
+// A WriteBatch::Handler that applies nothing, used to validate the
+// contents of a batch before any of it is written.
+class NullWriteBatchHandler : public WriteBatch::Handler {
+public:
+	virtual ~NullWriteBatchHandler() {}
+	virtual void Put(const Slice& key, const Slice& value) {}
+	virtual void Delete(const Slice& key) {}
+};
+
+// Apply updates laid out as the contents of a WriteBatch.
+Status
+DbImpl::Write(const WriteOptions& options, const Slice& contents)
+{
+	NullWriteBatchHandler check;
+	Status status = WriteBatchInternal::Iterate(contents, &check);
+	if (!status.ok())
+		return status;
+
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	int ret;
+
+	do {
+		if ((ret = beginWrite(session, options, true)) != 0)
+			break;
+		WriteBatchHandler handler(context.getCursor());
+		status = WriteBatchInternal::Iterate(contents, &handler);
+		ret = endWrite(session, options, true, handler.getStatus());
+	} while (ret == WT_DEADLOCK);
+	if (ret != 0)
+		return Status::IOError(wiredtiger_strerror(ret));
 	return status;
 }
 
+// Most keys DeleteRange removes in one transaction.  WiredTiger's
+// truncate of a range on an LSM tree or a row-store btree removes the
+// keys one by one through a cursor anyway, in a single transaction that
+// grows with the range, so the keys are removed here the same way, a
+// transaction at a time.
+static const int kDeleteRangeChunk = 10000;
+
+// Remove the entries in a range of keys.  Each transaction carries on
+// from the first key the last one didn't reach, found again since
+// committing resets the cursor.
+Status
+DbImpl::DeleteRange(const WriteOptions& options,
+    const Slice* begin, bool include_begin,
+    const Slice* end, bool include_end)
+{
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	WT_CURSOR *cursor = context.getCursor();
+	WT_ITEM item;
+	std::string next;
+	Slice from, key;
+	bool has_from = begin != NULL, include_from = include_begin;
+	bool done = false;
+	int cmp, n, ret;
+
+	if (has_from)
+		from = *begin;
+	do {
+		if ((ret = beginWrite(session, options, true)) != 0)
+			break;
+		if (!has_from)
+			ret = cursor->next(cursor);
+		else {
+			item.data = from.data();
+			item.size = from.size();
+			cursor->set_key(cursor, &item);
+			ret = cursor->search_near(cursor, &cmp);
+			if (ret == 0 &&
+			    (cmp < 0 || (cmp == 0 && !include_from)))
+				ret = cursor->next(cursor);
+		}
+		for (n = 0; ret == 0; n++) {
+			ret = cursor->get_key(cursor, &item);
+			assert(ret == 0);
+			key = Slice((const char *)item.data, item.size);
+			if (end != NULL && ((cmp = key.compare(*end)) > 0 ||
+			    (cmp == 0 && !include_end))) {
+				ret = WT_NOTFOUND;
+				break;
+			}
+			if (n == kDeleteRangeChunk) {
+				// Carry on from here in a new transaction.
+				next.assign(key.data(), key.size());
+				break;
+			}
+			if ((ret = cursor->remove(cursor)) == 0)
+				ret = cursor->next(cursor);
+		}
+		if (ret == WT_NOTFOUND) {
+			done = true;
+			ret = 0;
+		}
+		ret = endWrite(session, options, true, ret);
+		if (ret == 0 && !done) {
+			from = next;
+			has_from = include_from = true;
+		}
+	} while ((ret == 0 && !done) || ret == WT_DEADLOCK);
+
+	if (ret != 0)
+		return Status::IOError(wiredtiger_strerror(ret));
+	return Status::OK();
+}
+
+// A WriteBatch::Handler that only accepts puts, used to check the
+// contents of a batch before any of it is bulk loaded.
+class BulkWriteBatchCheck : public WriteBatch::Handler {
+public:
+	BulkWriteBatchCheck() : deletes_(false) {}
+	virtual ~BulkWriteBatchCheck() {}
+	bool hasDeletes() { return deletes_; }
+	virtual void Put(const Slice& key, const Slice& value) {}
+	virtual void Delete(const Slice& key) { deletes_ = true; }
+
+private:
+	bool deletes_;
+};
+
+/*
+ * Loads entries through a bulk cursor on the data table, in a session of
+ * its own.  WiredTiger writes them into a new LSM chunk, and adds it to
+ * the tree as the oldest chunk when the cursor is closed, or drops it if
+ * an insert failed.
+ */
+class BulkLoaderImpl : public leveldb::BulkLoader {
+public:
+	BulkLoaderImpl(WT_SESSION *session, WT_CURSOR *cursor, int *active) : session_(session), cursor_(cursor), active_(active), status_(0) {}
+	virtual ~BulkLoaderImpl() {
+		(void)Finish();
+	}
+
+	virtual Status Put(const Slice& key, const Slice& value) {
+		if (session_ == NULL)
+			return Status::InvalidArgument("bulk load finished");
+		if (status_ == 0)
+			status_ = insert(key, value);
+		return getStatus();
+	}
+
+	virtual Status Write(const Slice& contents) {
+		if (session_ == NULL)
+			return Status::InvalidArgument("bulk load finished");
+		BulkWriteBatchCheck check;
+		Status status = WriteBatchInternal::Iterate(contents, &check);
+		if (!status.ok())
+			return status;
+		if (check.hasDeletes())
+			return Status::InvalidArgument(
+			    "bulk load batches may only hold puts");
+		BulkWriteBatchHandler handler(this);
+		(void)WriteBatchInternal::Iterate(contents, &handler);
+		return getStatus();
+	}
+
+	virtual Status Finish() {
+		if (session_ == NULL)
+			return getStatus();
+		// Closing the session closes the bulk cursor, which
+		// installs the chunk.
+		int ret = session_->close(session_, NULL);
+		session_ = NULL;
+		cursor_ = NULL;
+		__sync_lock_release(active_);
+		if (status_ == 0)
+			status_ = ret;
+		return getStatus();
+	}
+
+private:
+	// Apply the puts in a WriteBatch, stopping at the first failure.
+	class BulkWriteBatchHandler : public WriteBatch::Handler {
+	public:
+		BulkWriteBatchHandler(BulkLoaderImpl *loader) : loader_(loader) {}
+		virtual ~BulkWriteBatchHandler() {}
+		virtual void Put(const Slice& key, const Slice& value) {
+			if (loader_->status_ == 0)
+				loader_->status_ = loader_->insert(key, value);
+		}
+		virtual void Delete(const Slice& key) {}
+
+	private:
+		BulkLoaderImpl *loader_;
+	};
+
+	WT_SESSION *session_;
+	WT_CURSOR *cursor_;
+	int *active_;
+	int status_;
+
+	int insert(const Slice& key, const Slice& value) {
+		WT_ITEM item;
+
+		item.data = key.data();
+		item.size = key.size();
+		cursor_->set_key(cursor_, &item);
+		item.data = value.data();
+		item.size = value.size();
+		cursor_->set_value(cursor_, &item);
+		return (cursor_->insert(cursor_));
+	}
+
+	// A bulk cursor fails an insert with EINVAL if the key isn't
+	// larger than the one before.
+	Status getStatus() const {
+		if (status_ == 0)
+			return Status::OK();
+		if (status_ == EINVAL)
+			return Status::InvalidArgument(
+			    "bulk load keys must be in increasing order");
+		return Status::IOError(wiredtiger_strerror(status_));
+	}
+};
+
+// Start a bulk load.  WiredTiger refuses a bulk cursor on an LSM tree
+// that has anything in it.  A bulk cursor on a btree needs the table to
+// itself, which it never has while the contexts keep cursors open on it,
+// so btree tables can't be bulk loaded.
+Status
+DbImpl::NewBulkLoader(leveldb::BulkLoader** loader)
+{
+	WT_SESSION *session;
+	WT_CURSOR *cursor;
+	int ret;
+
+	if (!__sync_bool_compare_and_swap(&bulkLoading_, 0, 1))
+		return Status::InvalidArgument("a bulk load is already running");
+	if ((ret = conn_->open_session(conn_, NULL, NULL, &session)) != 0) {
+		__sync_lock_release(&bulkLoading_);
+		return Status::IOError(wiredtiger_strerror(ret));
+	}
+	ret = session->open_cursor(session, "metadata:", NULL, NULL, &cursor);
+	assert(ret == 0);
+	std::string source = getSource(cursor);
+	ret = cursor->close(cursor);
+	assert(ret == 0);
+	if (source.compare(0, strlen("lsm:"), "lsm:") != 0) {
+		(void)session->close(session, NULL);
+		__sync_lock_release(&bulkLoading_);
+		return Status::NotSupported("bulk load requires an LSM table");
+	}
+	ret = session->open_cursor(
+	    session, uri_.c_str(), NULL, "bulk", &cursor);
+	if (ret != 0) {
+		(void)session->close(session, NULL);
+		__sync_lock_release(&bulkLoading_);
+		if (ret == EINVAL)
+			return Status::InvalidArgument(
+			    "bulk load requires an empty database");
+		return Status::IOError(wiredtiger_strerror(ret));
+	}
+	*loader = new BulkLoaderImpl(session, cursor, &bulkLoading_);
+	return Status::OK();
+}
+
 // If the database contains an entry for "key" store the
 // corresponding value in *value and return OK.
 //
@@ -495,7 +1463,14 @@ Status
 DbImpl::Get(const ReadOptions& options,
 	     const Slice& key, std::string* value)
 {
-	WT_CURSOR *cursor = getCursor();
+	SnapshotImpl *snapshot = (SnapshotImpl *)options.snapshot;
+	SnapshotLock l(snapshot);
+	ScopedContext context(snapshot == NULL ? contexts_ : NULL, table_, uri_);
+	WT_CURSOR *cursor = context.getCursor();
+	Status status = snapshot != NULL ?
+	    snapshot->getCursor(table_, uri_, &cursor) : context.status();
+	if (!status.ok())
+		return status;
 	WT_ITEM item;
 
 	item.data = key.data();
@@ -511,6 +1486,73 @@ DbImpl::Get(const ReadOptions& options,
 	return Status::OK();
 }
 
+// Search "cursor" for "key", copying the value found into a buffer
+// allocated with new[].
+static Status
+searchValue(WT_CURSOR *cursor, const Slice& key, char** value, size_t* size)
+{
+	WT_ITEM item;
+
+	item.data = key.data();
+	item.size = key.size();
+	cursor->set_key(cursor, &item);
+	int ret = cursor->search(cursor);
+	if (ret == WT_NOTFOUND)
+		return Status::NotFound("DB::Get key not found");
+	assert(ret == 0);
+	ret = cursor->get_value(cursor, &item);
+	assert(ret == 0);
+	*value = new char[item.size];
+	memcpy(*value, item.data, item.size);
+	*size = item.size;
+	return Status::OK();
+}
+
+// As above, but copy the value directly from the cursor into a buffer
+// allocated with new[].  The caller owns *value on success.
+Status
+DbImpl::Get(const ReadOptions& options,
+	     const Slice& key, char** value, size_t* size)
+{
+	SnapshotImpl *snapshot = (SnapshotImpl *)options.snapshot;
+	SnapshotLock l(snapshot);
+	ScopedContext context(snapshot == NULL ? contexts_ : NULL, table_, uri_);
+	WT_CURSOR *cursor = context.getCursor();
+	Status status = snapshot != NULL ?
+	    snapshot->getCursor(table_, uri_, &cursor) : context.status();
+	if (!status.ok())
+		return status;
+
+	return searchValue(cursor, key, value, size);
+}
+
+// As above, for every key in "keys", all searched for on one cursor
+// checked out once for the whole call.
+Status
+DbImpl::Get(const ReadOptions& options,
+	     const std::vector<Slice>& keys, char** values, size_t* sizes)
+{
+	SnapshotImpl *snapshot = (SnapshotImpl *)options.snapshot;
+	SnapshotLock l(snapshot);
+	ScopedContext context(snapshot == NULL ? contexts_ : NULL, table_, uri_);
+	WT_CURSOR *cursor = context.getCursor();
+	Status status = snapshot != NULL ?
+	    snapshot->getCursor(table_, uri_, &cursor) : context.status();
+	if (!status.ok())
+		return status;
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		values[i] = NULL;
+		sizes[i] = 0;
+	}
+	for (size_t i = 0; i < keys.size(); i++) {
+		Status status = searchValue(cursor, keys[i], &values[i], &sizes[i]);
+		if (!status.ok() && !status.IsNotFound())
+			return status;
+	}
+	return Status::OK();
+}
+
 // Return a heap-allocated iterator over the contents of the database.
 // The result of NewIterator() is initially invalid (caller must
 // call one of the Seek methods on the iterator before using it).
@@ -520,7 +1562,26 @@ DbImpl::Get(const ReadOptions& options,
 Iterator *
 DbImpl::NewIterator(const ReadOptions& options)
 {
-	return new IteratorImpl(getCursor(), this, options);
+	return NewIterator(options, leveldb::IteratorBounds());
+}
+
+Iterator *
+DbImpl::NewIterator(const ReadOptions& options,
+    const leveldb::IteratorBounds& bounds)
+{
+	SnapshotImpl *snapshot = (SnapshotImpl *)options.snapshot;
+	if (snapshot == NULL)
+		return new IteratorImpl(contexts_, table_, uri_, options, bounds);
+
+	SnapshotLock l(snapshot);
+	WT_SESSION *session = snapshot->getSession();
+	WT_CURSOR *cursor;
+	int ret = session->open_cursor(
+	    session, uri_.c_str(), NULL, NULL, &cursor);
+	if (ret != 0)
+		return new IteratorImpl(Status::IOError(
+		    "cannot open a cursor", wiredtiger_strerror(ret)));
+	return new IteratorImpl(cursor, options, bounds);
 }
 
 // Return a handle to the current DB state.  Iterators created with
@@ -530,17 +1591,76 @@ DbImpl::NewIterator(const ReadOptions& options)
 const Snapshot *
 DbImpl::GetSnapshot()
 {
-	return new SnapshotImpl(this);
+	SnapshotImpl *snapshot = new SnapshotImpl(conn_);
+	if (!snapshot->status().ok()) {
+		delete snapshot;
+		return NULL;
+	}
+	return snapshot;
 }
 
 // Release a previously acquired snapshot.  The caller must not
-// use "snapshot" after this call.
+// use "snapshot" after this call, and any iterators reading from it
+// must have been deleted.
 void
 DbImpl::ReleaseSnapshot(const Snapshot* snapshot)
 {
 	delete (SnapshotImpl *)snapshot;
 }
 
+// Properties holding a single WiredTiger statistic, see GetProperty.
+static const struct {
+	const char *name;
+	bool table;		// From the table's statistics
+	int key;
+} statProperties[] = {
+	{ "wiredtiger.cache.bytes", false, WT_STAT_CONN_CACHE_BYTES_INUSE },
+	{ "wiredtiger.cache.bytes-dirty",
+	    false, WT_STAT_CONN_CACHE_BYTES_DIRTY },
+	{ "wiredtiger.cache.bytes-max", false, WT_STAT_CONN_CACHE_BYTES_MAX },
+	{ "wiredtiger.cache.evictions-dirty",
+	    false, WT_STAT_CONN_CACHE_EVICTION_DIRTY },
+	{ "wiredtiger.log.bytes", false, WT_STAT_CONN_LOG_BYTES_WRITTEN },
+	{ "wiredtiger.log.syncs", false, WT_STAT_CONN_LOG_SYNC },
+	{ "wiredtiger.lsm.chunks", true, WT_STAT_DSRC_LSM_CHUNK_COUNT },
+	{ "wiredtiger.lsm.generation-max",
+	    true, WT_STAT_DSRC_LSM_GENERATION_MAX },
+	{ "wiredtiger.bloom.hits", true, WT_STAT_DSRC_BLOOM_HIT },
+	{ "wiredtiger.bloom.misses", true, WT_STAT_DSRC_BLOOM_MISS },
+	{ "wiredtiger.bloom.false-positives",
+	    true, WT_STAT_DSRC_BLOOM_FALSE_POSITIVE },
+};
+
+// Open a statistics cursor on the connection, or the table if "table"
+// isn't NULL.  Fails if the database was opened without statistics.
+static int
+openStatCursor(WT_SESSION *session, const char *table, WT_CURSOR **cursorp)
+{
+	std::string uri("statistics:");
+	if (table != NULL)
+		uri += table;
+	return (session->open_cursor(
+	    session, uri.c_str(), NULL, NULL, cursorp));
+}
+
+// Append a line "description: value" for each statistic a cursor has.
+static int
+dumpStats(WT_SESSION *session, const char *table, std::stringstream *out)
+{
+	WT_CURSOR *cursor;
+	const char *desc, *pvalue;
+	uint64_t v;
+	int ret;
+
+	if ((ret = openStatCursor(session, table, &cursor)) != 0)
+		return (ret);
+	while ((ret = cursor->next(cursor)) == 0 &&
+	    (ret = cursor->get_value(cursor, &desc, &pvalue, &v)) == 0)
+		*out << desc << ": " << pvalue << "\n";
+	(void)cursor->close(cursor);
+	return (ret == WT_NOTFOUND ? 0 : ret);
+}
+
 // DB implementations can export properties about their state
 // via this method.  If "property" is a valid property understood by this
 // DB implementation, fills "*value" with its current value and returns
@@ -549,19 +1669,260 @@ DbImpl::ReleaseSnapshot(const Snapshot* snapshot)
 //
 // Valid property names include:
 //
-//  "leveldb.num-files-at-level<N>" - return the number of files at level <N>,
-//     where <N> is an ASCII representation of a level number (e.g. "0").
-//  "leveldb.stats" - returns a multi-line string that describes statistics
-//     about the internal operation of the DB.
-//  "leveldb.sstables" - returns a multi-line string that describes all
-//     of the sstables that make up the db contents.
+//  "wiredtiger.stats" - returns a multi-line string of every statistic
+//     WiredTiger keeps for the connection, followed by those for the
+//     table.  "leveldb.stats" returns the same.
+//  "wiredtiger.cache.bytes", "wiredtiger.lsm.chunks" and the others in
+//     statProperties - return the value of a single statistic.
+//
+// These need the database to have been opened with statistics.
 bool
 DbImpl::GetProperty(const Slice& property, std::string* value)
 {
-	/* Not supported */
+	if (!statistics_)
+		return false;
+
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return false;
+	WT_SESSION *session = context.getSession();
+
+	if (property == "wiredtiger.stats" || property == "leveldb.stats") {
+		std::stringstream out;
+		out << "connection\n";
+		if (dumpStats(session, NULL, &out) != 0)
+			return false;
+		out << uri_ << "\n";
+		if (dumpStats(session, uri_.c_str(), &out) != 0)
+			return false;
+		*value = out.str();
+		return true;
+	}
+
+	for (size_t i = 0;
+	    i < sizeof(statProperties) / sizeof(statProperties[0]); i++) {
+		if (property != statProperties[i].name)
+			continue;
+
+		WT_CURSOR *cursor;
+		const char *desc, *pvalue;
+		uint64_t v;
+		if (openStatCursor(session,
+		    statProperties[i].table ? uri_.c_str() : NULL, &cursor) != 0)
+			return false;
+		cursor->set_key(cursor, statProperties[i].key);
+		int ret = cursor->search(cursor);
+		if (ret == 0)
+			ret = cursor->get_value(cursor, &desc, &pvalue, &v);
+		(void)cursor->close(cursor);
+		if (ret != 0)
+			return false;
+		std::stringstream out;
+		out << v;
+		*value = out.str();
+		return true;
+	}
 	return false;
 }
 
+// Look up "key" in a configuration string, returning whether it is there.
+// The value refers to the memory holding "config".
+static bool
+configGet(const char *config, size_t len, const char *key,
+    WT_CONFIG_ITEM *value)
+{
+	WT_CONFIG_PARSER *parser;
+
+	if (wiredtiger_config_parser_open(NULL, config, len, &parser) != 0)
+		return (false);
+	int ret = parser->get(parser, key, value);
+	(void)parser->close(parser);
+	return (ret == 0);
+}
+
+static bool
+configKeyIs(const WT_CONFIG_ITEM &key, const char *name)
+{
+	return (key.len == strlen(name) && strncmp(key.str, name, key.len) == 0);
+}
+
+// Read the size of a data file on disk and sample its keys.  Returns
+// false if the file is empty or can't be read.
+bool
+DbImpl::readDataFile(WT_SESSION *session, const std::string &uri,
+    DataFile *file)
+{
+	std::string path = home_ + "/" + uri.substr(strlen("file:"));
+	struct stat sb;
+	if (stat(path.c_str(), &sb) != 0)
+		return (false);
+	file->uri = uri;
+	file->size = (uint64_t)sb.st_size;
+	file->keys.clear();
+	file->chunk = file->written = false;
+
+	WT_CURSOR *cursor;
+	WT_ITEM item;
+	std::string first, last;
+	int ret = session->open_cursor(session, uri.c_str(), NULL, NULL, &cursor);
+	if (ret != 0)
+		return (false);
+	if ((ret = cursor->next(cursor)) == 0 &&
+	    (ret = cursor->get_key(cursor, &item)) == 0) {
+		first.assign((const char *)item.data, item.size);
+		if ((ret = cursor->reset(cursor)) == 0 &&
+		    (ret = cursor->prev(cursor)) == 0 &&
+		    (ret = cursor->get_key(cursor, &item)) == 0)
+			last.assign((const char *)item.data, item.size);
+	}
+	(void)cursor->close(cursor);
+	if (ret != 0)
+		return (false);
+
+	// A file still only in memory may have nothing to sample from.
+	file->keys.push_back(first);
+	if (session->open_cursor(session,
+	    uri.c_str(), NULL, "next_random=true", &cursor) == 0) {
+		for (int i = 0; i < WT_SIZE_SAMPLES; i++) {
+			if (cursor->next(cursor) != 0 ||
+			    cursor->get_key(cursor, &item) != 0)
+				break;
+			file->keys.push_back(
+			    std::string((const char *)item.data, item.size));
+		}
+		(void)cursor->close(cursor);
+	}
+	file->keys.push_back(last);
+	std::sort(file->keys.begin(), file->keys.end());
+	return (true);
+}
+
+// Return the data source behind the table, "file:..." for a btree or
+// "lsm:..." for an LSM tree, read through metadata cursor "meta".
+std::string
+DbImpl::getSource(WT_CURSOR *meta)
+{
+	WT_CONFIG_ITEM value;
+	const char *config;
+	std::string colgroup("colgroup:"), source;
+
+	colgroup += uri_.substr(strlen("table:"));
+	meta->set_key(meta, colgroup.c_str());
+	if (meta->search(meta) == 0 && meta->get_value(meta, &config) == 0 &&
+	    configGet(config, strlen(config), "source", &value))
+		source.assign(value.str, value.len);
+	return (source);
+}
+
+// Find the files holding the table's data: the file behind a btree, or
+// each chunk of an LSM tree, found from the metadata.
+void
+DbImpl::getDataFiles(WT_SESSION *session, std::vector<DataFile> *files)
+{
+	WT_CURSOR *meta;
+	WT_CONFIG_ITEM value;
+	const char *config;
+
+	int ret = session->open_cursor(session, "metadata:", NULL, NULL, &meta);
+	assert(ret == 0);
+	std::string source = getSource(meta);
+
+	DataFile file;
+	if (source.compare(0, strlen("file:"), "file:") == 0) {
+		if (readDataFile(session, source, &file))
+			files->push_back(file);
+	} else if (source.compare(0, strlen("lsm:"), "lsm:") == 0) {
+		// The chunk list is "[id=N,...,id=M,...]", a chunk that
+		// has been written out has a chunk_size.
+		std::vector<std::pair<uint32_t, bool> > chunks;
+		meta->set_key(meta, source.c_str());
+		WT_CONFIG_PARSER *parser;
+		WT_CONFIG_ITEM k, v;
+		if (meta->search(meta) == 0 &&
+		    meta->get_value(meta, &config) == 0 &&
+		    configGet(config, strlen(config), "chunks", &value) &&
+		    value.len >= 2 && wiredtiger_config_parser_open(NULL,
+		    value.str + 1, value.len - 2, &parser) == 0) {
+			while (parser->next(parser, &k, &v) == 0)
+				if (configKeyIs(k, "id"))
+					chunks.push_back(std::make_pair(
+					    (uint32_t)v.val, false));
+				else if (configKeyIs(k, "chunk_size") &&
+				    !chunks.empty())
+					chunks.back().second = true;
+			(void)parser->close(parser);
+		}
+
+		std::string prefix = "file:" + source.substr(strlen("lsm:"));
+		std::map<uint32_t, DataFile> written;
+		(void)pthread_mutex_lock(&chunksLock_);
+		for (size_t i = 0; i < chunks.size(); i++) {
+			uint32_t id = chunks[i].first;
+			std::map<uint32_t, DataFile>::iterator cached =
+			    chunks_.find(id);
+			if (cached != chunks_.end()) {
+				files->push_back(cached->second);
+				written.insert(*cached);
+				continue;
+			}
+			char name[32];
+			snprintf(name, sizeof(name), "-%06u.lsm", id);
+			if (!readDataFile(session, prefix + name, &file))
+				continue;
+			file.chunk = true;
+			file.written = chunks[i].second;
+			files->push_back(file);
+			if (file.written)
+				written[id] = file;
+		}
+		// Forget chunks that have been merged away.
+		chunks_.swap(written);
+		(void)pthread_mutex_unlock(&chunksLock_);
+	}
+	ret = meta->close(meta);
+	assert(ret == 0);
+}
+
+// Place a key on a scale from "lo" (0) to "hi" (1), where lo < key < hi,
+// treating the eight bytes after their common prefix as a number.
+static double
+keyBetween(const Slice &key, const std::string &lo, const std::string &hi)
+{
+	size_t prefix = 0;
+	while (prefix < lo.size() && prefix < hi.size() &&
+	    lo[prefix] == hi[prefix])
+		prefix++;
+
+	double k = 0, l = 0, h = 0;
+	for (size_t i = prefix; i < prefix + 8; i++) {
+		k = k * 256 + (i < key.size() ? (unsigned char)key[i] : 0);
+		l = l * 256 + (i < lo.size() ? (unsigned char)lo[i] : 0);
+		h = h * 256 + (i < hi.size() ? (unsigned char)hi[i] : 0);
+	}
+	if (h <= l)
+		return (0.5);
+	return (std::min(1.0, std::max(0.0, (k - l) / (h - l))));
+}
+
+// Place a key on a scale from the first key in a file (0) to the last
+// (1).  The sampled keys split the file into pieces holding about the
+// same share of its entries, the key is placed within its piece.
+static double
+keyPosition(const Slice &key, const DataFile &file)
+{
+	const std::vector<std::string> &keys = file.keys;
+
+	if (key.compare(keys.front()) <= 0)
+		return (0.0);
+	if (key.compare(keys.back()) >= 0)
+		return (1.0);
+	size_t i = 1;
+	while (key.compare(keys[i]) > 0)
+		i++;
+	return ((i - 1 + keyBetween(key, keys[i - 1], keys[i])) /
+	    (keys.size() - 1));
+}
+
 // For each i in [0,n-1], store in "sizes[i]", the approximate
 // file system space used by keys in "[range[i].start .. range[i].limit)".
 //
@@ -570,15 +1931,42 @@ DbImpl::GetProperty(const Slice& property, std::string* value)
 // sizes will be one-tenth the size of the corresponding user data size.
 //
 // The results may not include the sizes of recently written data.
+//
+// Each file holding table data is assumed to spread its size evenly
+// between its first and last keys, and contributes the share that falls
+// in the range.  Written LSM chunks are only read once, after that this
+// costs a metadata lookup plus a few cursor operations on the chunk
+// still being filled.
 void
 DbImpl::GetApproximateSizes(const Range* range, int n,
 			   uint64_t* sizes)
 {
+	std::vector<DataFile> files;
 	int i;
 
-	/* XXX Not supported */
-	for (i = 0; i < n; i++)
-		sizes[i] = 1;
+	{
+		ScopedContext context(contexts_, table_, uri_);
+		if (context.status().ok())
+			getDataFiles(context.getSession(), &files);
+	}
+	for (i = 0; i < n; i++) {
+		double size = 0;
+		for (size_t j = 0; j < files.size(); j++) {
+			double from = keyPosition(range[i].start, files[j]);
+			double to = keyPosition(range[i].limit, files[j]);
+			if (to > from)
+				size += (to - from) * files[j].size;
+		}
+		sizes[i] = (uint64_t)size;
+	}
+}
+
+// Return whether a data file holds keys in the range [*begin,*end].
+static bool
+fileOverlaps(const DataFile &file, const Slice* begin, const Slice* end)
+{
+	return ((begin == NULL || begin->compare(file.keys.back()) <= 0) &&
+	    (end == NULL || end->compare(file.keys.front()) >= 0));
 }
 
 // Compact the underlying storage for the key range [*begin,*end].
@@ -594,9 +1982,63 @@ DbImpl::GetApproximateSizes(const Range* range, int n,
 void
 DbImpl::CompactRange(const Slice* begin, const Slice* end)
 {
-	WT_SESSION *session = getContext()->getSession();
-	int ret = session->compact(session, WT_URI, NULL);
-	assert(ret == 0);
+	Status status = CompactRange(begin, end, NULL);
+	assert(status.ok());
+}
+
+// Each data file overlapping the range is compacted on its own, which
+// gives the free space inside it back to the file system.  The chunk an
+// LSM tree is still filling is left alone.  Overwritten and deleted
+// entries in an LSM tree only go away when chunks are merged, which
+// WiredTiger only does for the whole tree: that is done if more than one
+// chunk overlaps the range.
+Status
+DbImpl::CompactRange(const Slice* begin, const Slice* end,
+    leveldb::CompactionStats* stats)
+{
+	ScopedContext context(contexts_, table_, uri_);
+	if (!context.status().ok())
+		return context.status();
+	WT_SESSION *session = context.getSession();
+	std::vector<DataFile> files;
+	leveldb::CompactionStats s;
+	int chunks = 0, ret = 0;
+
+	getDataFiles(session, &files);
+	s.files_before = (int)files.size();
+	for (size_t i = 0; i < files.size(); i++) {
+		s.bytes_before += files[i].size;
+		if (!fileOverlaps(files[i], begin, end))
+			continue;
+		if (files[i].chunk)
+			chunks++;
+		if (files[i].chunk && !files[i].written)
+			continue;
+		// A chunk being merged away is busy, that is fine.
+		ret = session->compact(session, files[i].uri.c_str(), NULL);
+		if (ret == EBUSY || ret == ENOENT)
+			ret = 0;
+		else if (ret != 0)
+			break;
+		else
+			s.files_compacted++;
+	}
+	if (ret == 0 && chunks > 1) {
+		ret = session->compact(session, uri_.c_str(), NULL);
+		s.merged = ret == 0;
+	}
+
+	files.clear();
+	getDataFiles(session, &files);
+	s.files_after = (int)files.size();
+	for (size_t i = 0; i < files.size(); i++)
+		s.bytes_after += files[i].size;
+	if (stats != NULL)
+		*stats = s;
+
+	if (ret != 0)
+		return Status::IOError(wiredtiger_strerror(ret));
+	return Status::OK();
 }
 
 // Suspends the background compaction thread.  This methods
@@ -614,22 +2056,96 @@ DbImpl::ResumeCompactions()
 	/* Not supported */
 }
 
-// Position at the first key in the source.  The iterator is Valid()
-// after this call iff the source is not empty.
 void
-IteratorImpl::SeekToFirst()
+IteratorImpl::setBounds(const leveldb::IteratorBounds &bounds)
+{
+	has_lower_ = bounds.lower != NULL;
+	has_upper_ = bounds.upper != NULL;
+	if (has_lower_)
+		lower_.assign(bounds.lower->data(), bounds.lower->size());
+	if (has_upper_)
+		upper_.assign(bounds.upper->data(), bounds.upper->size());
+	lower_inclusive_ = bounds.lower_inclusive;
+	upper_inclusive_ = bounds.upper_inclusive;
+	limit_ = bounds.limit;
+	count_ = 0;
+
+	prefix_ = 0;
+	if (has_lower_ && has_upper_) {
+		size_t n = std::min(lower_.size(), upper_.size());
+		while (prefix_ < n && lower_[prefix_] == upper_[prefix_])
+			prefix_++;
+	}
+}
+
+// Return whether a key the cursor is on lies within the bounds.
+bool
+IteratorImpl::inBounds(const WT_ITEM &key) const
+{
+	const char *data = (const char *)key.data;
+	int cmp;
+
+	if (prefix_ > 0 &&
+	    (key.size < prefix_ || memcmp(data, lower_.data(), prefix_) != 0))
+		return (false);
+	Slice rest(data + prefix_, key.size - prefix_);
+	if (has_lower_) {
+		cmp = rest.compare(
+		    Slice(lower_.data() + prefix_, lower_.size() - prefix_));
+		if (cmp < 0 || (cmp == 0 && !lower_inclusive_))
+			return (false);
+	}
+	if (has_upper_) {
+		cmp = rest.compare(
+		    Slice(upper_.data() + prefix_, upper_.size() - prefix_));
+		if (cmp > 0 || (cmp == 0 && !upper_inclusive_))
+			return (false);
+	}
+	return (true);
+}
+
+// Move the cursor onto the nearest key to a bound in the direction of
+// travel, stepping over the bound itself if it isn't in the range.
+int
+IteratorImpl::seekBound(const std::string &bound, bool inclusive, bool forward)
+{
+	WT_ITEM item;
+	int cmp, ret;
+
+	item.data = bound.data();
+	item.size = bound.size();
+	cursor_->set_key(cursor_, &item);
+	ret = cursor_->search_near(cursor_, &cmp);
+	if (ret == 0 && cmp == 0 && !inclusive)
+		cmp = forward ? -1 : 1;
+	if (ret == 0 && forward && cmp < 0)
+		ret = cursor_->next(cursor_);
+	else if (ret == 0 && !forward && cmp > 0)
+		ret = cursor_->prev(cursor_);
+	return (ret);
+}
+
+// Pick up the entry the cursor is on after a move that returned "ret".
+// The iterator is Valid() iff the move found an entry, it is within the
+// bounds and the limit hasn't been reached.
+void
+IteratorImpl::positioned(int ret)
 {
 	WT_ITEM item;
 
-	int ret = cursor_->reset(cursor_);
-	assert(ret == 0);
-	ret = cursor_->next(cursor_);
 	if (ret != 0) {
+		if (ret != WT_NOTFOUND)
+			status_ = Status::IOError(wiredtiger_strerror(ret));
 		valid_ = false;
 		return;
 	}
 	ret = cursor_->get_key(cursor_, &item);
 	assert(ret == 0);
+	if ((limit_ >= 0 && count_ >= limit_) || !inBounds(item)) {
+		valid_ = false;
+		return;
+	}
+	count_++;
 	key_ = Slice((const char *)item.data, item.size);
 	ret = cursor_->get_value(cursor_, &item);
 	assert(ret == 0);
@@ -637,27 +2153,40 @@ IteratorImpl::SeekToFirst()
 	valid_ = true;
 }
 
+// Position at the first key in the source.  The iterator is Valid()
+// after this call iff the source is not empty.
+void
+IteratorImpl::SeekToFirst()
+{
+	SnapshotLock l(snapshot_);
+
+	if (cursor_ == NULL)
+		return;
+	int ret = cursor_->reset(cursor_);
+	assert(ret == 0);
+	if (has_lower_)
+		ret = seekBound(lower_, lower_inclusive_, true);
+	else
+		ret = cursor_->next(cursor_);
+	positioned(ret);
+}
+
 // Position at the last key in the source.  The iterator is
 // Valid() after this call iff the source is not empty.
 void
 IteratorImpl::SeekToLast()
 {
-	WT_ITEM item;
+	SnapshotLock l(snapshot_);
 
-	int ret = cursor_->reset(cursor_);
-	assert(ret == 0);
-	ret = cursor_->prev(cursor_);
-	if (ret != 0) {
-		valid_ = false;
+	if (cursor_ == NULL)
 		return;
-	}
-	ret = cursor_->get_key(cursor_, &item);
-	assert(ret == 0);
-	key_ = Slice((const char *)item.data, item.size);
-	ret = cursor_->get_value(cursor_, &item);
+	int ret = cursor_->reset(cursor_);
 	assert(ret == 0);
-	value_ = Slice((const char *)item.data, item.size);
-	valid_ = true;
+	if (has_upper_)
+		ret = seekBound(upper_, upper_inclusive_, false);
+	else
+		ret = cursor_->prev(cursor_);
+	positioned(ret);
 }
 
 // Position at the first key in the source that at or past target
@@ -667,26 +2196,17 @@ void
 IteratorImpl::Seek(const Slice& target)
 {
 	WT_ITEM item;
+	SnapshotLock l(snapshot_);
 
+	if (cursor_ == NULL)
+		return;
 	item.data = target.data();
 	item.size = target.size();
 	cursor_->set_key(cursor_, &item);
 	int cmp, ret = cursor_->search_near(cursor_, &cmp);
 	if (ret == 0 && cmp < 0)
 		ret = cursor_->next(cursor_);
-	if (ret != 0) {
-		if (ret != WT_NOTFOUND)
-			status_ = Status::IOError(wiredtiger_strerror(ret));
-		valid_ = false;
-		return;
-	}
-	ret = cursor_->get_key(cursor_, &item);
-	assert(ret == 0);
-	key_ = Slice((const char *)item.data, item.size);
-	ret = cursor_->get_value(cursor_, &item);
-	assert(ret == 0);
-	value_ = Slice((const char *)item.data, item.size);
-	valid_ = true;
+	positioned(ret);
 }
 
 // Moves to the next entry in the source.  After this call, Valid() is
@@ -695,24 +2215,11 @@ IteratorImpl::Seek(const Slice& target)
 void
 IteratorImpl::Next()
 {
-	WT_ITEM item;
+	SnapshotLock l(snapshot_);
 
 	assert(valid_);
 
-	int ret = cursor_->next(cursor_);
-	if (ret != 0) {
-		if (ret != WT_NOTFOUND)
-			status_ = Status::IOError(wiredtiger_strerror(ret));
-		valid_ = false;
-		return;
-	}
-	ret = cursor_->get_key(cursor_, &item);
-	assert(ret == 0);
-	key_ = Slice((const char *)item.data, item.size);
-	ret = cursor_->get_value(cursor_, &item);
-	assert(ret == 0);
-	value_ = Slice((const char *)item.data, item.size);
-	valid_ = true;
+	positioned(cursor_->next(cursor_));
 }
 
 // Moves to the previous entry in the source.  After this call, Valid() is
@@ -721,22 +2228,9 @@ IteratorImpl::Next()
 void
 IteratorImpl::Prev()
 {
-	WT_ITEM item;
+	SnapshotLock l(snapshot_);
 
 	assert(valid_);
 
-	int ret = cursor_->prev(cursor_);
-	if (ret != 0) {
-		if (ret != WT_NOTFOUND)
-			status_ = Status::IOError(wiredtiger_strerror(ret));
-		valid_ = false;
-		return;
-	}
-	ret = cursor_->get_key(cursor_, &item);
-	assert(ret == 0);
-	key_ = Slice((const char *)item.data, item.size);
-	ret = cursor_->get_value(cursor_, &item);
-	assert(ret == 0);
-	value_ = Slice((const char *)item.data, item.size);
-	valid_ = true;
+	positioned(cursor_->prev(cursor_));
 }
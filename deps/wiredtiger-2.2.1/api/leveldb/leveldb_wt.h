@@ -24,4 +24,5 @@
 #include <leveldb/write_batch.h>
 #endif
 
+#include "leveldb_wt_db.h"
 #include "wiredtiger.h"
@@ -0,0 +1,244 @@
+/*-
+ * Copyright (c) 2008-2014 WiredTiger, Inc.
+ *	All rights reserved.
+ *
+ * See the file LICENSE for redistribution information.
+ */
+#ifndef _LEVELDB_WT_DB_H_
+#define _LEVELDB_WT_DB_H_ 1
+/*
+ * WiredTiger-specific extensions to the LevelDB DB interface.  Handles
+ * returned by leveldb::DB::Open can be cast to a WiredTigerDB.
+ */
+
+#include <utility>
+#include <vector>
+
+#ifdef HAVE_HYPERLEVELDB
+#include <hyperleveldb/db.h>
+#else
+#include <leveldb/db.h>
+#endif
+
+namespace leveldb {
+
+// Options that have no LevelDB equivalent, passed to WiredTigerDB::Open
+// alongside the usual Options.
+struct WiredTigerOptions {
+	// Most sessions (each with a cursor on the data table) kept open
+	// for reuse by reads, writes and iterators once they finish.
+	// Operations running beyond this many at once open a session of
+	// their own, closed again when they finish.
+	// Default: 32
+	int session_cache_size;
+
+	// Most sessions the WiredTiger connection may have open at once,
+	// counting cached sessions, snapshots and open iterators.  Beyond
+	// it operations fail with an IOError, iterators are never Valid()
+	// and report one in status(), and GetSnapshot returns NULL.
+	// Default: 256
+	int session_max;
+
+	// Statistics WiredTiger maintains, one of "none", "fast" or "all"
+	// (see the wiredtiger_open "statistics" configuration).  Properties
+	// read with GetProperty need at least "fast".
+	// Default: "fast"
+	std::string statistics;
+
+	// How a table created by Open stores its entries: "lsm" for an LSM
+	// tree, which suits write-heavy loads, or "btree" for a single
+	// WiredTiger btree, which serves reads without probing Bloom
+	// filters or merging chunks.  An existing table keeps the type it
+	// was created with.
+	// Default: "lsm"
+	std::string table_type;
+
+	// WiredTiger configuration strings added to the end of those built
+	// for wiredtiger_open and for WT_SESSION::create when the table is
+	// created, so their settings take precedence (for example
+	// "eviction_target=70,checkpoint=(wait=60)" or
+	// "lsm=(merge_max=10),prefix_compression=true").  WiredTiger checks
+	// them, and Open fails with InvalidArgument, giving WiredTiger's
+	// reason, if it rejects either.
+	// Default: ""
+	std::string connection_config;
+	std::string table_config;
+
+	// The name of the process-wide WiredTiger cache pool to put the
+	// connection's cache in, instead of a cache of its own.  The pool
+	// moves memory between the connections in it as their needs change,
+	// keeping at least shared_cache_reserve bytes for each, out of
+	// shared_cache_size bytes in all.  Only one pool can exist in a
+	// process, and the size given by the connection that joined last is
+	// the one used.  With a pool, the cache size otherwise worked out
+	// from Options is not used.  0 leaves a setting at WiredTiger's
+	// default: a 500MB pool, reserving one 10MB chunk per connection.
+	// Default: "" (no pool)
+	std::string shared_cache;
+	size_t shared_cache_size;
+	size_t shared_cache_reserve;
+
+	WiredTigerOptions();
+};
+
+// Limits on the entries an iterator made by
+// WiredTigerDB::NewIterator(options, bounds) stops on.
+struct IteratorBounds {
+	// Smallest and largest keys in the range, each NULL for no bound
+	// and included in the range if the matching flag is set.  The
+	// Slices need only stay valid for the NewIterator call.
+	// Default: NULL
+	const Slice* lower;
+	bool lower_inclusive;
+	const Slice* upper;
+	bool upper_inclusive;
+
+	// Most entries the iterator stops on, or -1 for no limit.
+	// Default: -1
+	int limit;
+
+	IteratorBounds();
+};
+
+// What WiredTigerDB::CompactRange found and did.  The data files are the
+// chunks of an LSM tree, or the one file behind a btree.
+struct CompactionStats {
+	int files_before, files_after;
+	uint64_t bytes_before, bytes_after;
+	int files_compacted;
+	bool merged;
+
+	CompactionStats();
+};
+
+// Loads entries into an empty database, made by
+// WiredTigerDB::NewBulkLoader.  The entries are written straight into a
+// new data file through a WiredTiger bulk cursor, skipping the cache,
+// the log and the merges Put and Write would go through, and the file
+// becomes part of the database when the load is finished.  Entries
+// written to the database while the load runs take precedence over
+// those loaded.  A loader is used from one thread at a time.
+class BulkLoader {
+public:
+	BulkLoader() {}
+	// Deleting a loader that hasn't been finished finishes it.
+	virtual ~BulkLoader();
+
+	// Add an entry.  Keys must be added in strictly increasing order.
+	virtual Status Put(const Slice& key, const Slice& value) = 0;
+
+	// Add the entries laid out as the contents of a WriteBatch (see
+	// db/write_batch.cc for the layout), which may only hold puts.
+	virtual Status Write(const Slice& contents) = 0;
+
+	// Make the entries loaded part of the database.  If adding an
+	// entry failed, none of them are.
+	virtual Status Finish() = 0;
+
+private:
+	// No copying allowed
+	BulkLoader(const BulkLoader&);
+	void operator=(const BulkLoader&);
+};
+
+class WiredTigerDB : public DB {
+public:
+	WiredTigerDB() : DB() {}
+	virtual ~WiredTigerDB() {}
+
+	// As for DB::Open, with WiredTiger-specific options.
+	static Status Open(const Options& options,
+		     const WiredTigerOptions& wt_options,
+		     const std::string& name,
+		     WiredTigerDB** dbptr);
+
+	using DB::CompactRange;
+	using DB::Get;
+	using DB::NewIterator;
+	using DB::Write;
+
+	// As for DB::Get, but the value is copied straight out of the
+	// WiredTiger cursor into a buffer allocated with new[], without an
+	// intermediate std::string.  On success the caller owns *value and
+	// must release it with delete[].
+	virtual Status Get(const ReadOptions& options,
+		     const Slice& key, char** value, size_t* size) = 0;
+
+	// As above, but for every key in "keys", looked up in the order
+	// given with one session and cursor, checked out once for the
+	// whole call instead of once per key.  Sets values[i] and sizes[i]
+	// for each key found and leaves values[i] NULL for a key that
+	// isn't.  Returns the first error other than NotFound, with the
+	// values found so far still for the caller to delete[].
+	virtual Status Get(const ReadOptions& options,
+		     const std::vector<Slice>& keys,
+		     char** values, size_t* sizes) = 0;
+
+	// As for DB::Write, but the updates are given as the contents of a
+	// WriteBatch (see db/write_batch.cc for the layout) held by the
+	// caller, so no WriteBatch needs to be built or copied.  The
+	// contents are checked in full before any update is applied.
+	virtual Status Write(const WriteOptions& options,
+		     const Slice& contents) = 0;
+
+	// As for DB::Write, but each batch is applied to the database
+	// handle it is paired with, all in a single transaction.  The
+	// handles must all be this one or namespaces opened through it
+	// (or through the handle it was opened through).
+	virtual Status Write(const WriteOptions& options,
+		     const std::vector<std::pair<WiredTigerDB*, WriteBatch*> >& updates) = 0;
+
+	// As for DB::NewIterator, but the iterator only stops on entries
+	// within "bounds": SeekToFirst and SeekToLast go to the first and
+	// last keys in the range, and the iterator becomes invalid as soon
+	// as it moves out of the range or has stopped on "bounds.limit"
+	// entries.  Keys are checked against the bounds in place, without
+	// being copied out of the WiredTiger cursor.
+	virtual Iterator* NewIterator(const ReadOptions& options,
+		     const IteratorBounds& bounds) = 0;
+
+	// As for DB::CompactRange, but only data files holding keys in the
+	// range are compacted, and an LSM tree only has its chunks merged
+	// if more than one of them overlaps the range.  Merging can take
+	// some seconds.  If "stats" isn't NULL it is filled in.
+	virtual Status CompactRange(const Slice* begin, const Slice* end,
+		     CompactionStats* stats) = 0;
+
+	// Remove every entry with a key between "begin" and "end", each
+	// included in the range if the matching "include_" flag is set.
+	// A NULL "begin" or "end" leaves that end of the range open.  The
+	// entries are removed one by one through a cursor, as WiredTiger's
+	// own truncate of a range does for these tables, in transactions of
+	// at most 10000 entries each, so a large range is not removed
+	// atomically: readers can see it partly removed, and an error
+	// leaves it so.  It is not an error if the range is empty.
+	virtual Status DeleteRange(const WriteOptions& options,
+		     const Slice* begin, bool include_begin,
+		     const Slice* end, bool include_end) = 0;
+
+	// Start loading entries into the database with a BulkLoader,
+	// stored in *loader, which the caller must delete once finished.
+	// Fails with InvalidArgument unless nothing has been written to
+	// the database yet, or if another load is running, and with
+	// NotSupported if the database's table is a btree.
+	virtual Status NewBulkLoader(BulkLoader** loader) = 0;
+
+	// Open a handle, stored in *dbptr, on the namespace "name": a
+	// table of its own in this database's WiredTiger connection,
+	// sharing its cache, log and sessions.  If "options.
+	// create_if_missing" is set and the namespace doesn't exist, it is
+	// created with the block_size, write_buffer_size, compression and
+	// filter_policy in "options" and the table_type and table_config in
+	// "wt_options", otherwise those are ignored, apart from checking
+	// table_config.  The rest of "wt_options" is ignored.  Names
+	// are letters, digits, '_' and '-'.  The caller must delete the
+	// handle, which can outlive this one: the connection is closed
+	// once every handle on it has been deleted.
+	virtual Status OpenNamespace(const Options& options,
+		     const WiredTigerOptions& wt_options,
+		     const std::string& name, WiredTigerDB** dbptr) = 0;
+};
+
+}  // namespace leveldb
+
+#endif
@@ -596,6 +596,10 @@ methods = {
 	    priority of the transaction for resolving conflicts.
 	    Transactions with higher values are less likely to abort''',
 	    min='-100', max='100'),
+	Config('sync', '', r'''
+	    whether to sync log records when the transaction commits,
+	    inherited from ::wiredtiger_open \c transaction_sync''',
+	    type='boolean'),
 ]),
 
 'session.commit_transaction' : Method([]),
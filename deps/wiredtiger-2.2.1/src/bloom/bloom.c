@@ -9,6 +9,12 @@
 
 #define	WT_BLOOM_TABLE_CONFIG "key_format=r,value_format=1t,exclusive=true"
 
+/*
+ * Bloom filters read into memory can't be evicted, keep them to this share of
+ * the cache so eviction has room to work.
+ */
+#define	WT_BLOOM_CACHE_SHARE	4
+
 static int __bloom_init(
     WT_SESSION_IMPL *, const char *, const char *, WT_BLOOM **);
 static int __bloom_setup(WT_BLOOM *, uint64_t, uint64_t, uint32_t, uint32_t);
@@ -245,6 +251,128 @@ __wt_bloom_hash(WT_BLOOM *bloom, WT_ITEM *key, WT_BLOOM_HASH *bhash)
 	return (0);
 }
 
+/*
+ * __bloom_bitmap_read --
+ *	Copy a finalized Bloom filter's bits into a bitmap.  Sets *readp if all
+ *	of them were copied: the leaf pages must cover bits 0 to m - 1 in order,
+ *	with no gaps.
+ */
+static int
+__bloom_bitmap_read(
+    WT_SESSION_IMPL *session, WT_BLOOM_BITMAP *bitmap, int *readp)
+{
+	WT_DECL_RET;
+	WT_PAGE *page;
+	WT_REF *ref;
+	uint64_t entries, i, next, start;
+
+	*readp = 0;
+	next = 0;
+
+	/*
+	 * The filter was bulk loaded from a bit string and not updated since,
+	 * so its bits are in the bitfields of the leaf pages, laid out as they
+	 * were in the bit string.  Pages read only for this aren't worth
+	 * keeping in the cache.
+	 */
+	for (ref = NULL;;) {
+		WT_ERR(__wt_tree_walk(session, &ref,
+		    WT_READ_NO_GEN | WT_READ_SKIP_INTL | WT_READ_WONT_NEED));
+		if (ref == NULL)
+			break;
+
+		/* Leave a filter that isn't laid out as expected on disk. */
+		page = ref->page;
+		if (page->type != WT_PAGE_COL_FIX || page->modify != NULL ||
+		    page->pg_fix_recno == 0 || page->pg_fix_recno > bitmap->m)
+			goto err;
+
+		/*
+		 * Records are numbered from 1, bits from 0.  A page that doesn't
+		 * start where the last one ended would leave bits unset, which
+		 * would read as false negatives.
+		 */
+		start = page->pg_fix_recno - 1;
+		if (start != next)
+			goto err;
+		entries = WT_MIN(page->pg_fix_entries, bitmap->m - start);
+		i = 0;
+		if (start % 8 == 0) {
+			memcpy(bitmap->bitstring + (start >> 3),
+			    page->pg_fix_bitf, (size_t)(entries >> 3));
+			i = entries & ~(uint64_t)7;
+		}
+		for (; i < entries; i++)
+			if (__bit_test(page->pg_fix_bitf, i))
+				__bit_set(bitmap->bitstring, start + i);
+		next = start + entries;
+	}
+	if (next == bitmap->m)
+		*readp = 1;
+
+err:	if (ref != NULL)
+		WT_TRET(__wt_page_release(session, ref));
+	return (ret);
+}
+
+/*
+ * __bloom_bitmap_open --
+ *	Find the filter's bitmap, reading the filter into memory if no other
+ *	session has.  Leaves the bitmap NULL if the filter doesn't fit in the
+ *	share of the cache Bloom filters may have.
+ */
+static int
+__bloom_bitmap_open(WT_BLOOM *bloom)
+{
+	WT_BLOOM_BITMAP *bitmap;
+	WT_BTREE *btree;
+	WT_CACHE *cache;
+	WT_CONNECTION_IMPL *conn;
+	WT_DECL_RET;
+	WT_SESSION_IMPL *session;
+	size_t size;
+	int read;
+
+	session = bloom->session;
+	conn = S2C(session);
+	cache = conn->cache;
+
+	/*
+	 * XXX Layering violation: the bitmap hangs off the filter's btree, so
+	 * it is shared by the sessions with the filter open.
+	 */
+	btree = ((WT_CURSOR_BTREE *)bloom->c)->btree;
+	if ((bloom->bitmap = btree->bloom_bitmap) != NULL)
+		return (0);
+
+	size = sizeof(WT_BLOOM_BITMAP) + __bitstr_size(bloom->m);
+	if (cache->bytes_bloom + size > conn->cache_size / WT_BLOOM_CACHE_SHARE)
+		return (0);
+
+	WT_RET(__wt_calloc_def(session, 1, &bitmap));
+	bitmap->m = bloom->m;
+	bitmap->size = size;
+	WT_ERR(__bit_alloc(session, bloom->m, &bitmap->bitstring));
+	WT_WITH_BTREE(session, btree,
+	    ret = __bloom_bitmap_read(session, bitmap, &read));
+	WT_ERR(ret);
+	if (!read)
+		goto err;
+
+	/* Another session may have read the filter in first. */
+	if (WT_ATOMIC_CAS(btree->bloom_bitmap, NULL, bitmap)) {
+		(void)WT_ATOMIC_ADD(cache->bytes_inmem, size);
+		(void)WT_ATOMIC_ADD(cache->bytes_bloom, size);
+		bloom->bitmap = bitmap;
+		return (0);
+	}
+	bloom->bitmap = btree->bloom_bitmap;
+
+err:	__wt_free(session, bitmap->bitstring);
+	__wt_free(session, bitmap);
+	return (ret);
+}
+
 /*
  * __wt_bloom_hash_get --
  *	Tests whether the key (as given by its hash signature) is in the Bloom
@@ -253,6 +381,7 @@ __wt_bloom_hash(WT_BLOOM *bloom, WT_ITEM *key, WT_BLOOM_HASH *bhash)
 int
 __wt_bloom_hash_get(WT_BLOOM *bloom, WT_BLOOM_HASH *bhash)
 {
+	WT_BLOOM_BITMAP *bitmap;
 	WT_CURSOR *c;
 	WT_DECL_RET;
 	int result;
@@ -270,6 +399,18 @@ __wt_bloom_hash_get(WT_BLOOM *bloom, WT_BLOOM_HASH *bhash)
 	h1 = bhash->h1;
 	h2 = bhash->h2;
 
+	/* Test the bits in memory if the filter can be read in. */
+	if (!bloom->bitmap_tried) {
+		bloom->bitmap_tried = 1;
+		WT_ERR(__bloom_bitmap_open(bloom));
+	}
+	if ((bitmap = bloom->bitmap) != NULL) {
+		for (i = 0; i < bloom->k; i++, h1 += h2)
+			if (!__bit_test(bitmap->bitstring, h1 % bitmap->m))
+				return (WT_NOTFOUND);
+		return (0);
+	}
+
 	result = 0;
 	for (i = 0; i < bloom->k; i++, h1 += h2) {
 		/*
@@ -351,3 +492,24 @@ __wt_bloom_drop(WT_BLOOM *bloom, const char *config)
 
 	return (ret);
 }
+
+/*
+ * __wt_bloom_bitmap_discard --
+ *	Free a Bloom filter read into memory, as its btree is closed.
+ */
+void
+__wt_bloom_bitmap_discard(WT_SESSION_IMPL *session, WT_BTREE *btree)
+{
+	WT_BLOOM_BITMAP *bitmap;
+	WT_CACHE *cache;
+
+	if ((bitmap = btree->bloom_bitmap) == NULL)
+		return;
+	btree->bloom_bitmap = NULL;
+
+	cache = S2C(session)->cache;
+	(void)WT_ATOMIC_SUB(cache->bytes_inmem, bitmap->size);
+	(void)WT_ATOMIC_SUB(cache->bytes_bloom, bitmap->size);
+	__wt_free(session, bitmap->bitstring);
+	__wt_free(session, bitmap);
+}
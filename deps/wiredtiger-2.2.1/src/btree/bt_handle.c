@@ -156,6 +156,9 @@ __wt_btree_close(WT_SESSION_IMPL *session)
 	/* Close the Huffman tree. */
 	__wt_btree_huffman_close(session);
 
+	/* Free a Bloom filter read into memory. */
+	__wt_bloom_bitmap_discard(session, btree);
+
 	/* Destroy locks. */
 	WT_TRET(__wt_rwlock_destroy(session, &btree->ovfl_lock));
 
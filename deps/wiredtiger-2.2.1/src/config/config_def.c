@@ -144,6 +144,7 @@ static const WT_CONFIG_CHECK confchk_session_begin_transaction[] = {
 	    NULL},
 	{ "name", "string", NULL, NULL},
 	{ "priority", "int", "min=-100,max=100", NULL},
+	{ "sync", "boolean", NULL, NULL},
 	{ NULL, NULL, NULL, NULL }
 };
 
@@ -388,7 +389,7 @@ static const WT_CONFIG_ENTRY config_entries[] = {
 	  confchk_index_meta
 	},
 	{ "session.begin_transaction",
-	  "isolation=,name=,priority=0",
+	  "isolation=,name=,priority=0,sync=",
 	  confchk_session_begin_transaction
 	},
 	{ "session.checkpoint",
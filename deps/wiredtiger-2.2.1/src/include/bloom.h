@@ -16,6 +16,8 @@ struct __wt_bloom {
 	uint8_t *bitstring;     /* For in memory representation. */
 	WT_SESSION_IMPL *session;
 	WT_CURSOR *c;
+	WT_BLOOM_BITMAP *bitmap;	/* Finalized filter read into memory */
+	int bitmap_tried;		/* Reading it has been tried */
 
 	uint32_t k;		/* The number of hash functions used. */
 	uint32_t factor;	/* The number of bits per item inserted. */
@@ -23,6 +25,20 @@ struct __wt_bloom {
 	uint64_t n;		/* The number of items to be inserted. */
 };
 
+/*
+ * WT_BLOOM_BITMAP --
+ *	A finalized Bloom filter read into memory, so it is probed with bit
+ *	tests instead of a search of its column store per bit.  It hangs off
+ *	the filter's btree handle, shared by every session, and is freed when
+ *	the handle is closed, which can't happen while a cursor (such as a
+ *	WT_BLOOM's) is open on it.
+ */
+struct __wt_bloom_bitmap {
+	uint8_t *bitstring;	/* The filter's bits */
+	uint64_t m;		/* The number of bits */
+	size_t size;		/* Bytes counted against the cache */
+};
+
 struct __wt_bloom_hash {
 	uint64_t h1, h2;	/* The two hashes used to calculate bits. */
 };
@@ -102,6 +102,8 @@ struct __wt_btree {
 
 	uint64_t last_recno;		/* Column-store last record number */
 
+	WT_BLOOM_BITMAP *bloom_bitmap;	/* Bloom filter read into memory */
+
 	WT_REF root;			/* Root page reference */
 	int modified;			/* If the tree ever modified */
 	int bulk_load_ok;		/* Bulk-load is a possibility */
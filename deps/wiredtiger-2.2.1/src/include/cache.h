@@ -46,6 +46,7 @@ struct __wt_cache {
 	uint64_t pages_evict;
 	uint64_t bytes_dirty;		/* Bytes/pages currently dirty */
 	uint64_t pages_dirty;
+	uint64_t bytes_bloom;		/* Bytes in Bloom filter bitmaps */
 
 	/*
 	 * Read information.
@@ -116,6 +116,7 @@ struct __wt_txn {
 
 	/* Scratch buffer for in-memory log records. */
 	WT_ITEM	       *logrec;
+	uint32_t	txn_logsync;	/* Log sync configuration */
 
 	/* Requested notification when transactions are resolved. */
 	WT_TXN_NOTIFY *notify;
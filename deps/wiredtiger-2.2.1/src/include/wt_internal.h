@@ -71,6 +71,8 @@ struct __wt_block_header;
     typedef struct __wt_block_header WT_BLOCK_HEADER;
 struct __wt_bloom;
     typedef struct __wt_bloom WT_BLOOM;
+struct __wt_bloom_bitmap;
+    typedef struct __wt_bloom_bitmap WT_BLOOM_BITMAP;
 struct __wt_bloom_hash;
     typedef struct __wt_bloom_hash WT_BLOOM_HASH;
 struct __wt_bm;
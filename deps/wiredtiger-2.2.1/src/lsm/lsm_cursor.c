@@ -1396,6 +1396,256 @@ err:	API_END(session, ret);
 	return (ret);
 }
 
+/*
+ * __clsm_insert_bulk --
+ *	WT_CURSOR->insert method for LSM bulk cursors.
+ */
+static int
+__clsm_insert_bulk(WT_CURSOR *cursor)
+{
+	WT_CURSOR *bulk_cursor;
+	WT_CURSOR_LSM *clsm;
+	WT_DECL_ITEM(buf);
+	WT_DECL_RET;
+	WT_ITEM value;
+	WT_SESSION_IMPL *session;
+
+	clsm = (WT_CURSOR_LSM *)cursor;
+	CURSOR_API_CALL(cursor, session, insert, NULL);
+	WT_CURSOR_NEEDKEY(cursor);
+	WT_CURSOR_NEEDVALUE(cursor);
+
+	bulk_cursor = clsm->cursors[0];
+	WT_ERR(__clsm_deleted_encode(session, &cursor->value, &value, &buf));
+	bulk_cursor->set_key(bulk_cursor, &cursor->key);
+	bulk_cursor->set_value(bulk_cursor, &value);
+	WT_ERR(bulk_cursor->insert(bulk_cursor));
+	++clsm->primary_chunk->count;
+
+err:	/* A chunk missing records must not join the tree. */
+	if (ret != 0)
+		F_SET(clsm, WT_CLSM_BULK_DISCARD);
+	__wt_scr_free(&buf);
+	API_END(session, ret);
+	return (ret);
+}
+
+/*
+ * __clsm_bulk_bloom --
+ *	Create a Bloom filter for a chunk that has been bulk-loaded.  The
+ *	chunk is installed with a generation the Bloom worker won't create
+ *	filters for, and it is rarely merged again, so it gets one now, before
+ *	it joins the tree, the way a merge creates one for the chunk it writes.
+ *	The filter is sized from the count of records loaded, so it is filled
+ *	from a pass over the finished chunk.
+ */
+static int
+__clsm_bulk_bloom(
+    WT_SESSION_IMPL *session, WT_LSM_TREE *lsm_tree, WT_LSM_CHUNK *chunk)
+{
+	WT_BLOOM *bloom;
+	WT_CURSOR *src;
+	WT_DECL_RET;
+	WT_ITEM key;
+	const char *cfg[3];
+
+	bloom = NULL;
+	src = NULL;
+
+	WT_RET(__wt_lsm_tree_bloom_name(
+	    session, lsm_tree, chunk->id, &chunk->bloom_uri));
+	WT_RET(__wt_bloom_create(session, chunk->bloom_uri,
+	    lsm_tree->bloom_config, chunk->count, lsm_tree->bloom_bit_count,
+	    lsm_tree->bloom_hash_count, &bloom));
+
+	/* Discard pages we read as soon as we're done with them. */
+	F_SET(session, WT_SESSION_NO_CACHE);
+
+	cfg[0] = WT_CONFIG_BASE(session, session_open_cursor);
+	cfg[1] = "raw";
+	cfg[2] = NULL;
+	WT_ERR(__wt_open_cursor(session, chunk->uri, NULL, cfg, &src));
+	while ((ret = src->next(src)) == 0) {
+		WT_ERR(src->get_key(src, &key));
+		WT_ERR(__wt_bloom_insert(bloom, &key));
+	}
+	WT_ERR_NOTFOUND_OK(ret);
+	WT_ERR(__wt_bloom_finalize(bloom));
+
+	F_CLR(session, WT_SESSION_NO_CACHE);
+
+	/* Load the new Bloom filter into cache. */
+	WT_CLEAR(key);
+	WT_ERR_NOTFOUND_OK(__wt_bloom_get(bloom, &key));
+
+	F_SET(chunk, WT_LSM_CHUNK_BLOOM);
+
+err:	if (src != NULL)
+		WT_TRET(src->close(src));
+	if (bloom != NULL)
+		WT_TRET(__wt_bloom_close(bloom));
+	F_CLR(session, WT_SESSION_NO_CACHE);
+	return (ret);
+}
+
+/*
+ * __clsm_close_bulk --
+ *	WT_CURSOR->close method for LSM bulk cursors: install the chunk that
+ *	was loaded as the oldest chunk in the tree.
+ */
+static int
+__clsm_close_bulk(WT_CURSOR *cursor)
+{
+	WT_CURSOR *bulk_cursor;
+	WT_CURSOR_LSM *clsm;
+	WT_DECL_RET;
+	WT_LSM_CHUNK *chunk;
+	WT_LSM_TREE *lsm_tree;
+	WT_SESSION_IMPL *session;
+	uint64_t n;
+	int installed, tret;
+	const char *drop_cfg[3];
+
+	clsm = (WT_CURSOR_LSM *)cursor;
+	session = (WT_SESSION_IMPL *)cursor->session;
+	lsm_tree = clsm->lsm_tree;
+	chunk = clsm->primary_chunk;
+	bulk_cursor = clsm->cursors[0];
+	clsm->primary_chunk = NULL;
+	clsm->cursors[0] = NULL;
+	installed = 0;
+
+	/* Closing the bulk cursor writes out the chunk. */
+	ret = bulk_cursor->close(bulk_cursor);
+	if (F_ISSET(clsm, WT_CLSM_BULK_DISCARD))
+		chunk->count = 0;
+	if (ret == 0 && chunk->count > 0)
+		ret = __wt_lsm_tree_set_chunk_size(session, chunk);
+	if (ret == 0 && chunk->count > 0 &&
+	    !FLD_ISSET(lsm_tree->bloom, WT_LSM_BLOOM_OFF))
+		ret = __clsm_bulk_bloom(session, lsm_tree, chunk);
+	if (ret == 0 && chunk->count > 0)
+		ret = __wt_lsm_tree_lock(session, lsm_tree, 1);
+	if (ret == 0 && chunk->count > 0) {
+		ret = __wt_realloc_def(session, &lsm_tree->chunk_alloc,
+		    lsm_tree->nchunks + 1, &lsm_tree->chunk);
+		if (ret == 0) {
+			memmove(lsm_tree->chunk + 1, lsm_tree->chunk,
+			    lsm_tree->nchunks * sizeof(*lsm_tree->chunk));
+			lsm_tree->chunk[0] = chunk;
+			++lsm_tree->nchunks;
+			installed = 1;
+
+			/*
+			 * Give the chunk the generation a series of merges
+			 * would have reached building a chunk of its size,
+			 * so it isn't merged again with every small chunk.
+			 */
+			if (lsm_tree->chunk_size > 0 &&
+			    lsm_tree->merge_min > 1)
+				for (n = chunk->size / lsm_tree->chunk_size;
+				    n >= lsm_tree->merge_min;
+				    n /= lsm_tree->merge_min)
+					++chunk->generation;
+			F_SET(chunk, WT_LSM_CHUNK_ONDISK);
+
+			ret = __wt_lsm_meta_write(session, lsm_tree);
+			++lsm_tree->dsk_gen;
+		}
+		WT_TRET(__wt_lsm_tree_unlock(session, lsm_tree));
+	}
+
+	/* Drop the chunk if it is empty or couldn't be loaded. */
+	if (!installed) {
+		drop_cfg[0] = WT_CONFIG_BASE(session, session_drop);
+		drop_cfg[1] = "force";
+		drop_cfg[2] = NULL;
+		WT_WITH_SCHEMA_LOCK(session,
+		    tret = __wt_schema_drop(session, chunk->uri, drop_cfg));
+		WT_TRET(tret);
+		if (chunk->bloom_uri != NULL) {
+			WT_WITH_SCHEMA_LOCK(session, tret =
+			    __wt_schema_drop(session, chunk->bloom_uri, drop_cfg));
+			WT_TRET(tret);
+		}
+		__wt_free(session, chunk->bloom_uri);
+		__wt_free(session, chunk->uri);
+		__wt_free(session, chunk);
+	}
+
+	WT_TRET(__clsm_close(cursor));
+	return (ret);
+}
+
+/*
+ * __clsm_open_bulk --
+ *	Set up an LSM cursor for bulk-load.  The records are written into a
+ *	new chunk through a bulk cursor, the chunk joins the tree when the
+ *	cursor is closed.
+ */
+static int
+__clsm_open_bulk(WT_CURSOR_LSM *clsm)
+{
+	WT_CURSOR *cursor;
+	WT_DECL_RET;
+	WT_LSM_CHUNK *chunk;
+	WT_LSM_TREE *lsm_tree;
+	WT_SESSION_IMPL *session;
+	int empty, tret;
+	const char *cfg[3];
+
+	cursor = &clsm->iface;
+	session = (WT_SESSION_IMPL *)cursor->session;
+	lsm_tree = clsm->lsm_tree;
+
+	/*
+	 * The chunk is added to the tree as its oldest, only allow that into a
+	 * tree that nothing has been written to.
+	 */
+	WT_RET(__wt_lsm_tree_lock(session, lsm_tree, 0));
+	empty = lsm_tree->nchunks == 1 &&
+	    lsm_tree->chunk[0]->count == 0 &&
+	    !F_ISSET(lsm_tree->chunk[0], WT_LSM_CHUNK_ONDISK);
+	WT_RET(__wt_lsm_tree_unlock(session, lsm_tree));
+	if (!empty)
+		WT_RET_MSG(session, EINVAL,
+		    "bulk-load is only supported on newly created LSM trees");
+
+	WT_RET(__wt_calloc_def(session, 1, &clsm->cursors));
+	clsm->cursor_alloc = 1;
+
+	WT_RET(__wt_calloc_def(session, 1, &chunk));
+	chunk->id = WT_ATOMIC_ADD(lsm_tree->last, 1);
+	WT_WITH_SCHEMA_LOCK(session,
+	    ret = __wt_lsm_tree_setup_chunk(session, lsm_tree, chunk));
+	WT_ERR(ret);
+
+	cfg[0] = WT_CONFIG_BASE(session, session_open_cursor);
+	cfg[1] = "bulk,raw";
+	cfg[2] = NULL;
+	WT_ERR(__wt_open_cursor(session, chunk->uri, NULL, cfg,
+	    &clsm->cursors[0]));
+	clsm->primary_chunk = chunk;
+
+	/* Bulk cursors only support insert and close. */
+	__wt_cursor_set_notsup(cursor);
+	cursor->insert = __clsm_insert_bulk;
+	cursor->close = __clsm_close_bulk;
+
+	if (0) {
+err:		if (chunk->uri != NULL) {
+			cfg[0] = WT_CONFIG_BASE(session, session_drop);
+			cfg[1] = "force";
+			WT_WITH_SCHEMA_LOCK(session, tret =
+			    __wt_schema_drop(session, chunk->uri, cfg));
+			WT_TRET(tret);
+		}
+		__wt_free(session, chunk->uri);
+		__wt_free(session, chunk);
+	}
+	return (ret);
+}
+
 /*
  * __wt_clsm_open --
  *	WT_SESSION->open_cursor method for LSM cursors.
@@ -1460,11 +1710,16 @@ __wt_clsm_open(WT_SESSION_IMPL *session,
 	 */
 	clsm->dsk_gen = 0;
 
+	WT_ERR(__wt_config_gets_def(session, cfg, "bulk", 0, &cval));
+	if (cval.val != 0)
+		WT_ERR(__clsm_open_bulk(clsm));
+
 	STATIC_ASSERT(offsetof(WT_CURSOR_LSM, iface) == 0);
 	WT_ERR(__wt_cursor_init(cursor, cursor->uri, owner, cfg, cursorp));
 
 	if (0) {
-err:		if (lsm_tree != NULL)
+err:		/* Once the cursor holds the tree, closing it releases it. */
+		if (clsm == NULL || clsm->lsm_tree == NULL)
 			__wt_lsm_tree_release(session, lsm_tree);
 		if (cursor != NULL)
 			WT_TRET(__clsm_close(cursor));
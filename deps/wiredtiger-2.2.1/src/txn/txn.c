@@ -252,6 +252,19 @@ __wt_txn_begin(WT_SESSION_IMPL *session, const char *cfg[])
 		    WT_STRING_MATCH("read-committed", cval.str, cval.len) ?
 		    TXN_ISO_READ_COMMITTED : TXN_ISO_READ_UNCOMMITTED;
 
+	/*
+	 * Asking for a sync when the connection doesn't sync the log at all
+	 * means flushing it at commit.  Concurrent commits share the flush.
+	 */
+	WT_RET(__wt_config_gets_def(session, cfg, "sync", 0, &cval));
+	if (cval.len == 0)
+		txn->txn_logsync = S2C(session)->txn_logsync;
+	else if (cval.val == 0)
+		txn->txn_logsync = 0;
+	else
+		txn->txn_logsync = S2C(session)->txn_logsync != 0 ?
+		    S2C(session)->txn_logsync : WT_LOG_FSYNC;
+
 	F_SET(txn, TXN_RUNNING);
 	if (txn->isolation == TXN_ISO_SNAPSHOT)
 		__wt_txn_refresh(session, WT_TXN_NONE, 1);
@@ -0,0 +1,88 @@
+// Packs an array of batch() operations into a single Buffer for
+// db.batchBuffer(), laid out like the contents of a LevelDB WriteBatch:
+//
+//   sequence: fixed64 (ignored, zero)
+//   count:    fixed32
+//   records:  0x01 varstring(key) varstring(value)   for a put
+//             0x00 varstring(key)                     for a del
+//
+// where varstring is a varint32 length followed by the bytes. All
+// integers are little-endian.
+
+const TYPE_DEL = 0
+    , TYPE_PUT = 1
+    , HEADER   = 12
+
+function toBuffer (thing, name) {
+  if (thing === null || thing === undefined)
+    throw new Error(name + ' cannot be `null` or `undefined`')
+  var buf = Buffer.isBuffer(thing) ? thing : new Buffer(String(thing))
+  if (buf.length === 0)
+    throw new Error(name + ' cannot be an empty ' + (Buffer.isBuffer(thing) ? 'Buffer' : 'String'))
+  return buf
+}
+
+function varintLength (n) {
+  var len = 1
+  while (n >= 0x80) {
+    n >>>= 7
+    len++
+  }
+  return len
+}
+
+function writeVarint (buf, offset, n) {
+  while (n >= 0x80) {
+    buf[offset++] = (n & 0x7f) | 0x80
+    n >>>= 7
+  }
+  buf[offset++] = n
+  return offset
+}
+
+function writeSlice (buf, offset, slice) {
+  offset = writeVarint(buf, offset, slice.length)
+  slice.copy(buf, offset)
+  return offset + slice.length
+}
+
+module.exports = function encodeBatch (operations) {
+  if (!Array.isArray(operations))
+    throw new Error('encodeBatch() requires an array of operations')
+
+  var records = []
+    , size    = HEADER
+
+  operations.forEach(function (op) {
+    if (op === null || typeof op != 'object')
+      return
+    if (op.type === null || op.type === undefined)
+      throw new Error('type cannot be `null` or `undefined`')
+
+    var key = toBuffer(op.key, 'key')
+    if (op.type == 'del') {
+      records.push({ type: TYPE_DEL, key: key })
+      size += 1 + varintLength(key.length) + key.length
+    } else if (op.type == 'put') {
+      var value = toBuffer(op.value, 'value')
+      records.push({ type: TYPE_PUT, key: key, value: value })
+      size += 1 + varintLength(key.length) + key.length
+        + varintLength(value.length) + value.length
+    }
+  })
+
+  var buf    = new Buffer(size)
+    , offset = HEADER
+
+  buf.fill(0, 0, 8)
+  buf.writeUInt32LE(records.length, 8)
+
+  records.forEach(function (record) {
+    buf[offset++] = record.type
+    offset = writeSlice(buf, offset, record.key)
+    if (record.type == TYPE_PUT)
+      offset = writeSlice(buf, offset, record.value)
+  })
+
+  return buf
+}
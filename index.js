@@ -1 +1,22 @@
-module.exports = require('bindings')('wiredtigerdown.node').wiredtigerdown
+const binding  = require('bindings')('wiredtigerdown.node').wiredtigerdown
+    , bulkLoad = require('./bulk-load')
+
+// adds the methods written in JavaScript to a database or namespace handle
+function extend (db) {
+  var namespace = db.namespace
+  db.bulkLoad = bulkLoad
+  db.namespace = function () {
+    return extend(namespace.apply(db, arguments))
+  }
+  return db
+}
+
+function wiredtigerdown (location) {
+  return extend(binding(location))
+}
+
+wiredtigerdown.destroy = binding.destroy
+wiredtigerdown.repair  = binding.repair
+
+module.exports = wiredtigerdown
+module.exports.encodeBatch = require('./encode-batch')
@@ -0,0 +1,71 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#ifndef LD_ARENA_H
+#define LD_ARENA_H
+
+#include <stddef.h>
+#include <vector>
+
+namespace leveldown {
+
+/* A bump allocator for the copies made when String keys and values are
+ * marshalled into Slices. The first kInlineSize bytes live inside the
+ * Arena itself, so an Arena on the stack or inside a worker gives short
+ * keys and values without a heap allocation of their own, and everything
+ * handed out is freed at once when the Arena goes away.
+ */
+class Arena {
+public:
+  static const size_t kInlineSize = 64;
+  static const size_t kBlockSize = 4096;
+
+  Arena () : ptr(inlineBlock), remaining(kInlineSize) {}
+
+  ~Arena () {
+    for (size_t i = 0; i < blocks.size(); i++)
+      delete[] blocks[i];
+  }
+
+  char* Allocate (size_t bytes) {
+    if (bytes <= remaining) {
+      char* result = ptr;
+      ptr += bytes;
+      remaining -= bytes;
+      return result;
+    }
+    return AllocateFallback(bytes);
+  }
+
+private:
+  char* AllocateFallback (size_t bytes) {
+    if (bytes > kBlockSize / 4) {
+      // big values get a block of their own so we don't throw away
+      // what's left of the current one
+      char* result = new char[bytes];
+      blocks.push_back(result);
+      return result;
+    }
+
+    char* block = new char[kBlockSize];
+    blocks.push_back(block);
+    ptr = block + bytes;
+    remaining = kBlockSize - bytes;
+    return block;
+  }
+
+  char inlineBlock[kInlineSize];
+  char* ptr;
+  size_t remaining;
+  std::vector<char*> blocks;
+
+  // No copying allowed
+  Arena (const Arena&);
+  void operator= (const Arena&);
+};
+
+} // namespace leveldown
+
+#endif
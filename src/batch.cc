@@ -95,16 +95,15 @@ NAN_METHOD(Batch::Put) {
 
   v8::Local<v8::Value> keyBuffer = args[0];
   v8::Local<v8::Value> valueBuffer = args[1];
-  LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key)
-  LD_STRING_OR_BUFFER_TO_SLICE(value, valueBuffer, value)
+  // WriteBatch takes its own copy of the data
+  leveldown::Arena arena;
+  LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key, arena)
+  LD_STRING_OR_BUFFER_TO_SLICE(value, valueBuffer, value, arena)
 
   batch->batch->Put(key, value);
   if (!batch->hasData)
     batch->hasData = true;
 
-  DisposeStringOrBufferFromSlice(keyBuffer, key);
-  DisposeStringOrBufferFromSlice(valueBuffer, value);
-
   NanReturnValue(args.Holder());
 }
 
@@ -121,14 +120,13 @@ NAN_METHOD(Batch::Del) {
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], key)
 
   v8::Local<v8::Value> keyBuffer = args[0];
-  LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key)
+  leveldown::Arena arena;
+  LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key, arena)
 
   batch->batch->Delete(key);
   if (!batch->hasData)
     batch->hasData = true;
 
-  DisposeStringOrBufferFromSlice(keyBuffer, key);
-
   NanReturnValue(args.Holder());
 }
 
@@ -166,7 +164,7 @@ NAN_METHOD(Batch::Write) {
     // persist to prevent accidental GC
     v8::Local<v8::Object> _this = args.This();
     worker->SavePersistent("batch", _this);
-    NanAsyncQueueWorker(worker);
+    batch->database->QueueWriteWorker(worker);
   } else {
     LD_RUN_CALLBACK(v8::Local<v8::Function>::Cast(args[0]), 0, NULL);
   }
@@ -0,0 +1,175 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#include <node.h>
+#include <node_buffer.h>
+
+#include "nan.h"
+#include "database.h"
+#include "bulk_loader.h"
+#include "bulk_loader_async.h"
+
+namespace leveldown {
+
+static v8::Persistent<v8::FunctionTemplate> bulk_loader_constructor;
+
+// the header of a packed batch, see Database::BatchBuffer
+static const size_t kBatchBufferHeader = 12;
+
+BulkLoader::BulkLoader (Database* database) : database(database) {
+  loader   = NULL;
+  finished = false;
+  writing  = false;
+};
+
+BulkLoader::~BulkLoader () {
+  // deleting the engine loader finishes the load
+  if (loader != NULL)
+    delete loader;
+  if (!finished)
+    database->ForgetBulkLoader(this);
+  if (!persistentHandle.IsEmpty())
+    NanDispose(persistentHandle);
+};
+
+leveldb::Status BulkLoader::Finish () {
+  if (loader == NULL)
+    return leveldb::Status::InvalidArgument("database has been closed");
+  leveldb::Status status = loader->Finish();
+  delete loader;
+  loader = NULL;
+  return status;
+}
+
+leveldb::BulkLoader* BulkLoader::Detach () {
+  leveldb::BulkLoader* detached = loader;
+  loader   = NULL;
+  finished = true;
+  return detached;
+}
+
+void BulkLoader::Init () {
+  v8::Local<v8::FunctionTemplate> tpl =
+      v8::FunctionTemplate::New(BulkLoader::New);
+  NanAssignPersistent(v8::FunctionTemplate, bulk_loader_constructor, tpl);
+  tpl->SetClassName(NanSymbol("BulkLoader"));
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "write", BulkLoader::Write);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "finish", BulkLoader::Finish);
+}
+
+NAN_METHOD(BulkLoader::New) {
+  NanScope();
+
+  Database* database = node::ObjectWrap::Unwrap<Database>(args[0]->ToObject());
+
+  BulkLoader* bulkLoader = new BulkLoader(database);
+  bulkLoader->Wrap(args.This());
+
+  // the database must outlive its loaders
+  v8::Local<v8::Object> obj = v8::Object::New();
+  obj->Set(NanSymbol("database"), args[0]);
+  NanAssignPersistent(v8::Object, bulkLoader->persistentHandle, obj);
+
+  NanReturnValue(args.This());
+}
+
+v8::Local<v8::Object> BulkLoader::NewInstance (v8::Local<v8::Object> database) {
+  NanScope();
+
+  v8::Local<v8::FunctionTemplate> constructorHandle =
+      NanPersistentToLocal(bulk_loader_constructor);
+
+  v8::Handle<v8::Value> argv[1] = { database };
+  v8::Local<v8::Object> instance =
+      constructorHandle->GetFunction()->NewInstance(1, argv);
+
+  return scope.Close(instance);
+}
+
+NAN_METHOD(BulkLoader::Write) {
+  NanScope();
+
+  BulkLoader* bulkLoader = ObjectWrap::Unwrap<BulkLoader>(args.Holder());
+
+  if (args.Length() < 2 || !args[1]->IsFunction())
+    return NanThrowError("write() requires a callback argument");
+
+  v8::Local<v8::Function> callback = args[1].As<v8::Function>();
+
+  if (bulkLoader->finished) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "bulk load has been finished")
+  }
+
+  if (bulkLoader->writing) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "cannot call write() before previous write() has completed")
+  }
+
+  v8::Local<v8::Object> bufferHandle = args[0].As<v8::Object>();
+  if (!node::Buffer::HasInstance(args[0])) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "write() requires a Buffer")
+  }
+
+  size_t length = node::Buffer::Length(bufferHandle);
+  if (length < kBatchBufferHeader) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "write() Buffer is too short")
+  }
+
+  if (length == kBatchBufferHeader) {
+    LD_RUN_CALLBACK(callback, 0, NULL);
+    NanReturnUndefined();
+  }
+
+  leveldb::Slice contents(node::Buffer::Data(bufferHandle), length);
+
+  BulkLoadWriteWorker* worker = new BulkLoadWriteWorker(
+      bulkLoader
+    , new NanCallback(callback)
+    , contents
+    , bufferHandle
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("bulkLoader", _this);
+  bulkLoader->writing = true;
+  bulkLoader->database->QueueBulkLoadWorker(worker);
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(BulkLoader::Finish) {
+  NanScope();
+
+  BulkLoader* bulkLoader = ObjectWrap::Unwrap<BulkLoader>(args.Holder());
+
+  if (args.Length() == 0 || !args[0]->IsFunction())
+    return NanThrowError("finish() requires a callback argument");
+
+  v8::Local<v8::Function> callback = args[0].As<v8::Function>();
+
+  if (bulkLoader->finished) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "bulk load has been finished")
+  }
+
+  if (bulkLoader->writing) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "cannot call finish() before previous write() has completed")
+  }
+
+  bulkLoader->finished = true;
+  bulkLoader->database->ForgetBulkLoader(bulkLoader);
+
+  BulkLoadFinishWorker* worker = new BulkLoadFinishWorker(
+      bulkLoader
+    , new NanCallback(callback)
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("bulkLoader", _this);
+  bulkLoader->database->QueueBulkLoadWorker(worker);
+
+  NanReturnUndefined();
+}
+
+} // namespace leveldown
@@ -0,0 +1,55 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#ifndef LD_BULK_LOADER_H
+#define LD_BULK_LOADER_H
+
+#include <node.h>
+
+#include "nan.h"
+#include "database.h"
+
+namespace leveldown {
+
+class Database;
+
+/* Loads sorted entries into an empty database through a WiredTiger bulk
+ * cursor, see leveldb::BulkLoader. Entries are handed over as Buffers
+ * packed like a batchBuffer() batch holding only puts, one write() at a
+ * time, and become part of the database on finish(). A loader that is
+ * garbage collected or still running when the database is closed is
+ * finished then, once any write() in progress has completed.
+ */
+class BulkLoader : public node::ObjectWrap {
+public:
+  static void Init ();
+  static v8::Local<v8::Object> NewInstance (v8::Local<v8::Object> database);
+
+  BulkLoader (Database* database);
+  ~BulkLoader ();
+
+  // worker thread
+  leveldb::Status Finish ();
+
+  // main thread, hands the engine loader over to the database as it
+  // closes
+  leveldb::BulkLoader* Detach ();
+
+  Database* database;
+  leveldb::BulkLoader* loader;
+  bool writing;
+
+private:
+  bool finished;
+  v8::Persistent<v8::Object> persistentHandle;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Write);
+  static NAN_METHOD(Finish);
+};
+
+} // namespace leveldown
+
+#endif
@@ -0,0 +1,63 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#include "bulk_loader.h"
+#include "bulk_loader_async.h"
+
+namespace leveldown {
+
+/** BULK LOAD WRITE WORKER **/
+
+BulkLoadWriteWorker::BulkLoadWriteWorker (
+    BulkLoader* bulkLoader
+  , NanCallback *callback
+  , leveldb::Slice contents
+  , v8::Local<v8::Object> &bufferHandle
+) : AsyncWorker(bulkLoader->database, callback)
+  , bulkLoader(bulkLoader)
+  // close() may detach the loader while this write runs, it is only
+  // deleted once the write has completed
+  , loader(bulkLoader->loader)
+  , contents(contents)
+{
+  NanScope();
+
+  // the records are read straight out of the Buffer
+  SavePersistent("buffer", bufferHandle);
+};
+
+BulkLoadWriteWorker::~BulkLoadWriteWorker () {}
+
+void BulkLoadWriteWorker::Execute () {
+  SetStatus(loader->Write(contents));
+}
+
+void BulkLoadWriteWorker::WorkComplete () {
+  bulkLoader->writing = false;
+  AsyncWorker::WorkComplete();
+  database->ReleaseBulkLoadWorker();
+}
+
+/** BULK LOAD FINISH WORKER **/
+
+BulkLoadFinishWorker::BulkLoadFinishWorker (
+    BulkLoader* bulkLoader
+  , NanCallback *callback
+) : AsyncWorker(bulkLoader->database, callback)
+  , bulkLoader(bulkLoader)
+{};
+
+BulkLoadFinishWorker::~BulkLoadFinishWorker () {}
+
+void BulkLoadFinishWorker::Execute () {
+  SetStatus(bulkLoader->Finish());
+}
+
+void BulkLoadFinishWorker::WorkComplete () {
+  AsyncWorker::WorkComplete();
+  database->ReleaseBulkLoadWorker();
+}
+
+} // namespace leveldown
@@ -0,0 +1,54 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#ifndef LD_BULK_LOADER_ASYNC_H
+#define LD_BULK_LOADER_ASYNC_H
+
+#include <node.h>
+
+#include "nan.h"
+#include "async.h"
+#include "bulk_loader.h"
+#include "database.h"
+
+namespace leveldown {
+
+class BulkLoadWriteWorker : public AsyncWorker {
+public:
+  BulkLoadWriteWorker (
+      BulkLoader* bulkLoader
+    , NanCallback *callback
+    , leveldb::Slice contents
+    , v8::Local<v8::Object> &bufferHandle
+  );
+
+  virtual ~BulkLoadWriteWorker ();
+  virtual void Execute ();
+  virtual void WorkComplete ();
+
+private:
+  BulkLoader* bulkLoader;
+  leveldb::BulkLoader* loader;
+  leveldb::Slice contents;
+};
+
+class BulkLoadFinishWorker : public AsyncWorker {
+public:
+  BulkLoadFinishWorker (
+      BulkLoader* bulkLoader
+    , NanCallback *callback
+  );
+
+  virtual ~BulkLoadFinishWorker ();
+  virtual void Execute ();
+  virtual void WorkComplete ();
+
+private:
+  BulkLoader* bulkLoader;
+};
+
+} // namespace leveldown
+
+#endif
@@ -16,22 +16,50 @@
 #include "database_async.h"
 #include "batch.h"
 #include "iterator.h"
+#include "snapshot.h"
+#include "bulk_loader.h"
+#include "worker_pool.h"
 
 namespace leveldown {
 
 static v8::Persistent<v8::FunctionTemplate> database_constructor;
 
+static void CloseGroupCommitTimer (uv_handle_t* handle) {
+  delete (uv_timer_t*)handle;
+}
+
 Database::Database (char* location) : location(location) {
   db = NULL;
   currentIteratorId = 0;
   pendingCloseWorker = NULL;
   blockCache = NULL;
   filterPolicy = NULL;
+  pendingBatch = NULL;
+  groupCommit = false;
+  groupCommitWindow = 0;
+  groupCommitTimer = NULL;
+  groupCommitScheduled = false;
+  pendingSync = false;
+  groupCommitsInFlight = 0;
+  bulkLoadsInFlight = 0;
+  readPool = NULL;
+  writePool = NULL;
+  poolsStopping = 0;
+  stoppingCloseWorker = NULL;
+  root = this;
 };
 
 Database::~Database () {
   if (db != NULL)
     delete db;
+  if (pendingBatch != NULL)
+    delete pendingBatch;
+  if (groupCommitTimer != NULL)
+    uv_close((uv_handle_t*)groupCommitTimer, CloseGroupCommitTimer);
+  if (root != this)
+    root->ForgetNamespace(this);
+  if (!rootHandle.IsEmpty())
+    NanDispose(rootHandle);
   delete[] location;
 };
 
@@ -41,9 +69,10 @@ const char* Database::Location() const { return location; }
 
 leveldb::Status Database::OpenDatabase (
         leveldb::Options* options
+      , leveldb::WiredTigerOptions* wtOptions
       , std::string location
     ) {
-  return leveldb::DB::Open(*options, location, &db);
+  return leveldb::WiredTigerDB::Open(*options, *wtOptions, location, &db);
 }
 
 leveldb::Status Database::PutToDatabase (
@@ -57,9 +86,19 @@ leveldb::Status Database::PutToDatabase (
 leveldb::Status Database::GetFromDatabase (
         leveldb::ReadOptions* options
       , leveldb::Slice key
-      , std::string& value
+      , char** value
+      , size_t* valueSize
+    ) {
+  return db->Get(*options, key, value, valueSize);
+}
+
+leveldb::Status Database::GetManyFromDatabase (
+        leveldb::ReadOptions* options
+      , const std::vector<leveldb::Slice>& keys
+      , char** values
+      , size_t* valueSizes
     ) {
-  return db->Get(*options, key, &value);
+  return db->Get(*options, keys, values, valueSizes);
 }
 
 leveldb::Status Database::DeleteFromDatabase (
@@ -76,6 +115,47 @@ leveldb::Status Database::WriteBatchToDatabase (
   return db->Write(*options, batch);
 }
 
+leveldb::Status Database::WriteBatchesToDatabase (
+        leveldb::WriteOptions* options
+      , leveldb::WriteBatch* batch
+      , const std::vector< std::pair<Database*, leveldb::WriteBatch*> >& namespaceBatches
+    ) {
+  std::vector< std::pair<leveldb::WiredTigerDB*, leveldb::WriteBatch*> > updates;
+  updates.push_back(std::make_pair(db, batch));
+  for (size_t i = 0; i < namespaceBatches.size(); i++) {
+    updates.push_back(std::make_pair(
+        namespaceBatches[i].first->db
+      , namespaceBatches[i].second
+    ));
+  }
+  return db->Write(*options, updates);
+}
+
+leveldb::Status Database::WriteBufferToDatabase (
+        leveldb::WriteOptions* options
+      , leveldb::Slice contents
+    ) {
+  return db->Write(*options, contents);
+}
+
+leveldb::Status Database::ClearFromDatabase (
+        leveldb::WriteOptions* options
+      , const leveldb::Slice* begin
+      , bool includeBegin
+      , const leveldb::Slice* end
+      , bool includeEnd
+    ) {
+  return db->DeleteRange(*options, begin, includeBegin, end, includeEnd);
+}
+
+leveldb::Status Database::CompactRangeFromDatabase (
+        const leveldb::Slice* start
+      , const leveldb::Slice* end
+      , leveldb::CompactionStats* stats
+    ) {
+  return db->CompactRange(start, end, stats);
+}
+
 uint64_t Database::ApproximateSizeFromDatabase (const leveldb::Range* range) {
   uint64_t size;
   db->GetApproximateSizes(range, 1, &size);
@@ -89,8 +169,11 @@ void Database::GetPropertyFromDatabase (
   db->GetProperty(property, value);
 }
 
-leveldb::Iterator* Database::NewIterator (leveldb::ReadOptions* options) {
-  return db->NewIterator(*options);
+leveldb::Iterator* Database::NewIterator (
+        leveldb::ReadOptions* options
+      , const leveldb::IteratorBounds& bounds
+    ) {
+  return db->NewIterator(*options, bounds);
 }
 
 const leveldb::Snapshot* Database::NewSnapshot () {
@@ -98,7 +181,25 @@ const leveldb::Snapshot* Database::NewSnapshot () {
 }
 
 void Database::ReleaseSnapshot (const leveldb::Snapshot* snapshot) {
-  return db->ReleaseSnapshot(snapshot);
+  // a snapshot still pinned when the database was closed went with it
+  if (db != NULL)
+    db->ReleaseSnapshot(snapshot);
+}
+
+void Database::ForgetSnapshot (leveldown::Snapshot* snapshot) {
+  snapshots.erase(snapshot);
+}
+
+leveldb::Status Database::NewBulkLoader (leveldb::BulkLoader** loader) {
+  return db->NewBulkLoader(loader);
+}
+
+void Database::ForgetBulkLoader (leveldown::BulkLoader* bulkLoader) {
+  bulkLoaders.erase(bulkLoader);
+}
+
+void Database::ForgetNamespace (Database* ns) {
+  namespaces.erase(ns);
 }
 
 void Database::ReleaseIterator (uint32_t id) {
@@ -108,13 +209,159 @@ void Database::ReleaseIterator (uint32_t id) {
   // if there is a pending CloseWorker it means that we're waiting for
   // iterators to end before we can close them
   iterators.erase(id);
-  if (iterators.empty() && pendingCloseWorker != NULL) {
-    NanAsyncQueueWorker((AsyncWorker*)pendingCloseWorker);
+  if (iterators.empty() && groupCommitsInFlight == 0
+      && bulkLoadsInFlight == 0 && pendingCloseWorker != NULL) {
+    RunCloseWorker((AsyncWorker*)pendingCloseWorker);
+    pendingCloseWorker = NULL;
+  }
+}
+
+/* Worker queues, main thread only *****************************/
+
+// namespace handles use the pools of the database they were opened through,
+// which can't be closed before them
+
+void Database::QueueReadWorker (AsyncWorker* worker) {
+  if (root->readPool != NULL)
+    root->readPool->QueueWorker(worker);
+  else
+    NanAsyncQueueWorker(worker);
+}
+
+void Database::QueueWriteWorker (AsyncWorker* worker) {
+  if (root->writePool != NULL)
+    root->writePool->QueueWorker(worker);
+  else
+    NanAsyncQueueWorker(worker);
+}
+
+void Database::QueueBulkLoadWorker (AsyncWorker* worker) {
+  bulkLoadsInFlight++;
+  QueueWriteWorker(worker);
+}
+
+void Database::ReleaseBulkLoadWorker () {
+  // called as a bulk load write() or finish() completes, a close()
+  // waiting on it can go ahead once nothing else is outstanding
+  bulkLoadsInFlight--;
+  if (bulkLoadsInFlight == 0 && groupCommitsInFlight == 0
+      && iterators.empty() && pendingCloseWorker != NULL) {
+    RunCloseWorker((AsyncWorker*)pendingCloseWorker);
+    pendingCloseWorker = NULL;
+  }
+}
+
+void Database::RunCloseWorker (AsyncWorker* worker) {
+  // anything still queued on our own pools must run before the
+  // database goes away, the CloseWorker is queued once the pools have
+  // stopped; they clean themselves up when done
+  if (readPool == NULL && writePool == NULL) {
+    NanAsyncQueueWorker(worker);
+    return;
+  }
+  stoppingCloseWorker = worker;
+  poolsStopping = (readPool != NULL ? 1 : 0) + (writePool != NULL ? 1 : 0);
+  if (readPool != NULL) {
+    readPool->Shutdown(Database::PoolStopped, this);
+    readPool = NULL;
+  }
+  if (writePool != NULL) {
+    writePool->Shutdown(Database::PoolStopped, this);
+    writePool = NULL;
+  }
+}
+
+void Database::PoolStopped (void* arg) {
+  Database* database = static_cast<Database*>(arg);
+  if (--database->poolsStopping == 0) {
+    NanAsyncQueueWorker(database->stoppingCloseWorker);
+    database->stoppingCloseWorker = NULL;
+  }
+}
+
+/* Group commit, main thread only *****************************/
+
+void Database::SetGroupCommit (bool enabled, uint64_t window) {
+  groupCommit = enabled;
+  groupCommitWindow = window;
+  if (groupCommit && groupCommitTimer == NULL) {
+    pendingBatch = new leveldb::WriteBatch();
+    groupCommitTimer = new uv_timer_t;
+    uv_timer_init(uv_default_loop(), groupCommitTimer);
+    groupCommitTimer->data = this;
+  }
+}
+
+void Database::QueueGroupCommit (NanCallback* callback, bool sync) {
+  // the operation has already been appended to pendingBatch, hold on to
+  // the callback until the batch that carries it has been written
+  pendingCallbacks.push_back(callback);
+  if (sync)
+    pendingSync = true;
+
+  if (!groupCommitScheduled) {
+    groupCommitScheduled = true;
+    // libuv timers have millisecond resolution, round the window up; a
+    // zero window fires on the next turn of the event loop
+    uv_timer_start(
+        groupCommitTimer
+      , GroupCommitTimeout
+      , (groupCommitWindow + 999) / 1000
+      , 0
+    );
+  }
+}
+
+void Database::GroupCommitTimeout (uv_timer_t* handle, int status) {
+  NanScope();
+
+  Database* database = static_cast<Database*>(handle->data);
+  database->FlushGroupCommit();
+}
+
+void Database::FlushGroupCommit () {
+  if (groupCommitScheduled) {
+    uv_timer_stop(groupCommitTimer);
+    groupCommitScheduled = false;
+  }
+
+  if (pendingCallbacks.empty())
+    return;
+
+  GroupCommitWorker* worker = new GroupCommitWorker(
+      this
+    , pendingBatch
+    , pendingCallbacks
+    , pendingSync
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = NanObjectWrapHandle(this);
+  worker->SavePersistent("database", _this);
+
+  pendingBatch = new leveldb::WriteBatch();
+  pendingCallbacks.clear();
+  pendingSync = false;
+  groupCommitsInFlight++;
+
+  QueueWriteWorker(worker);
+}
+
+void Database::ReleaseGroupCommit () {
+  // called each time a group commit has been written, in the main thread,
+  // a pending CloseWorker waits for in-flight writes as well as iterators
+  groupCommitsInFlight--;
+  if (groupCommitsInFlight == 0 && bulkLoadsInFlight == 0
+      && iterators.empty() && pendingCloseWorker != NULL) {
+    RunCloseWorker((AsyncWorker*)pendingCloseWorker);
     pendingCloseWorker = NULL;
   }
 }
 
 void Database::CloseDatabase () {
+  // deleting a loader finishes its load
+  for (size_t i = 0; i < closingLoaders.size(); i++)
+    delete closingLoaders[i];
+  closingLoaders.clear();
   delete db;
   db = NULL;
   if (blockCache) {
@@ -147,11 +394,22 @@ void Database::Init () {
   NODE_SET_PROTOTYPE_METHOD(tpl, "close", Database::Close);
   NODE_SET_PROTOTYPE_METHOD(tpl, "put", Database::Put);
   NODE_SET_PROTOTYPE_METHOD(tpl, "get", Database::Get);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "getMany", Database::GetMany);
   NODE_SET_PROTOTYPE_METHOD(tpl, "del", Database::Delete);
   NODE_SET_PROTOTYPE_METHOD(tpl, "batch", Database::Batch);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "batchBuffer", Database::BatchBuffer);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "clear", Database::Clear);
   NODE_SET_PROTOTYPE_METHOD(tpl, "approximateSize", Database::ApproximateSize);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "compactRange", Database::CompactRange);
   NODE_SET_PROTOTYPE_METHOD(tpl, "getProperty", Database::GetProperty);
   NODE_SET_PROTOTYPE_METHOD(tpl, "iterator", Database::Iterator);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "snapshot", Database::Snapshot);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "bulkLoader", Database::BulkLoader);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "namespace", Database::Namespace);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "poolStats", Database::PoolStats);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "getSync", Database::GetSync);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "putSync", Database::PutSync);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "batchSync", Database::BatchSync);
 }
 
 NAN_METHOD(Database::New) {
@@ -189,11 +447,63 @@ v8::Handle<v8::Value> Database::NewInstance (v8::Local<v8::String> &location) {
   return instance;
 }
 
+static std::string StringOptionValue (
+    v8::Local<v8::Object> optionsObj
+  , v8::Handle<v8::String> opt
+  , const char* def
+) {
+  if (optionsObj.IsEmpty()
+      || !optionsObj->Has(opt)
+      || !optionsObj->Get(opt)->IsString())
+    return def;
+  char* value = NanFromV8String(
+      optionsObj->Get(opt).As<v8::Object>()
+    , Nan::UTF8
+    , NULL
+    , NULL
+    , 0
+    , v8::String::NO_OPTIONS
+  );
+  std::string result = value;
+  delete[] value;
+  return result;
+}
+
+// a size in bytes, which unlike NanUInt32OptionValue may be 4GB or more
+static size_t SizeOptionValue (
+    v8::Local<v8::Object> optionsObj
+  , v8::Handle<v8::String> opt
+  , size_t def
+) {
+  if (optionsObj.IsEmpty()
+      || !optionsObj->Has(opt)
+      || !optionsObj->Get(opt)->IsNumber()
+      || optionsObj->Get(opt)->NumberValue() < 0)
+    return def;
+  return static_cast<size_t>(optionsObj->Get(opt)->NumberValue());
+}
+
+// the `wiredtiger` object of configuration strings passed through to
+// WiredTiger, empty if there isn't one
+static v8::Local<v8::Object> WiredTigerOptionsObject (
+    v8::Local<v8::Object> optionsObj
+) {
+  if (optionsObj.IsEmpty()
+      || !optionsObj->Has(NanSymbol("wiredtiger"))
+      || !optionsObj->Get(NanSymbol("wiredtiger"))->IsObject())
+    return v8::Local<v8::Object>();
+  return optionsObj->Get(NanSymbol("wiredtiger")).As<v8::Object>();
+}
+
 NAN_METHOD(Database::Open) {
   NanScope();
 
   LD_METHOD_SETUP_COMMON(open, 0, 1)
 
+  if (database->db != NULL) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "open() requires a closed database")
+  }
+
   bool createIfMissing = NanBooleanOptionValue(
       optionsObj
     , NanSymbol("createIfMissing")
@@ -229,6 +539,52 @@ NAN_METHOD(Database::Open) {
     , NanSymbol("blockRestartInterval")
     , 16
   );
+  uint32_t sessionCacheSize = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("sessionCacheSize")
+    , 32
+  );
+  uint32_t sessionMax = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("sessionMax")
+    , 256
+  );
+  std::string statistics =
+      StringOptionValue(optionsObj, NanSymbol("statistics"), "fast");
+  std::string engine =
+      StringOptionValue(optionsObj, NanSymbol("engine"), "lsm");
+  v8::Local<v8::Object> wiredtigerObj =
+      WiredTigerOptionsObject(optionsObj);
+  std::string connectionConfig =
+      StringOptionValue(wiredtigerObj, NanSymbol("connection"), "");
+  std::string tableConfig =
+      StringOptionValue(wiredtigerObj, NanSymbol("table"), "");
+  std::string sharedCache =
+      StringOptionValue(optionsObj, NanSymbol("sharedCache"), "");
+  size_t sharedCacheSize =
+      SizeOptionValue(optionsObj, NanSymbol("sharedCacheSize"), 0);
+  size_t sharedCacheReserve =
+      SizeOptionValue(optionsObj, NanSymbol("sharedCacheReserve"), 0);
+
+  database->SetGroupCommit(
+      NanBooleanOptionValue(optionsObj, NanSymbol("groupCommit"))
+    , NanUInt32OptionValue(optionsObj, NanSymbol("groupCommitWindow"), 0)
+  );
+
+  uint32_t readThreads = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("readThreads")
+    , 0
+  );
+  uint32_t writeThreads = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("writeThreads")
+    , 0
+  );
+  if (readThreads > 0 && database->readPool == NULL)
+    database->readPool = new WorkerPool(readThreads);
+  if (writeThreads > 0 && database->writePool == NULL)
+    database->writePool = new WorkerPool(writeThreads);
 
   database->blockCache = leveldb::NewLRUCache(cacheSize);
   database->filterPolicy = leveldb::NewBloomFilterPolicy(10);
@@ -245,6 +601,15 @@ NAN_METHOD(Database::Open) {
     , blockSize
     , maxOpenFiles
     , blockRestartInterval
+    , sessionCacheSize
+    , sessionMax
+    , statistics
+    , engine
+    , connectionConfig
+    , tableConfig
+    , sharedCache
+    , sharedCacheSize
+    , sharedCacheReserve
   );
   // persist to prevent accidental GC
   v8::Local<v8::Object> _this = args.This();
@@ -259,6 +624,10 @@ NAN_METHOD(Database::Close) {
 
   LD_METHOD_SETUP_COMMON_ONEARG(close)
 
+  // the namespaces share the connection and pools, they go first
+  if (!database->namespaces.empty())
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "close() requires the database's namespaces to be closed first")
+
   CloseWorker* worker = new CloseWorker(
       database
     , new NanCallback(callback)
@@ -267,7 +636,39 @@ NAN_METHOD(Database::Close) {
   v8::Local<v8::Object> _this = args.This();
   worker->SavePersistent("database", _this);
 
-  if (!database->iterators.empty()) {
+  // write out anything still waiting for a group commit
+  if (database->groupCommit)
+    database->FlushGroupCommit();
+
+  // snapshots nothing is reading through are released now, the rest as
+  // soon as their reads and iterators are done
+  std::set< leveldown::Snapshot * > snapshots(database->snapshots);
+  for (
+      std::set< leveldown::Snapshot * >::iterator it = snapshots.begin()
+    ; it != snapshots.end()
+    ; ++it) {
+    (*it)->ReleaseSnapshot();
+  }
+
+  // bulk loads left running are finished by the CloseWorker, after any
+  // write() still in progress on them
+  for (
+      std::set< leveldown::BulkLoader * >::iterator it
+          = database->bulkLoaders.begin()
+    ; it != database->bulkLoaders.end()
+    ; ++it) {
+    leveldb::BulkLoader* loader = (*it)->Detach();
+    if (loader != NULL)
+      database->closingLoaders.push_back(loader);
+  }
+  database->bulkLoaders.clear();
+
+  if ((database->groupCommitsInFlight > 0 || database->bulkLoadsInFlight > 0)
+      && database->iterators.empty()) {
+    // the CloseWorker will be invoked by ReleaseGroupCommit() or
+    // ReleaseBulkLoadWorker() once the outstanding writes have landed
+    database->pendingCloseWorker = worker;
+  } else if (!database->iterators.empty()) {
     // yikes, we still have iterators open! naughty naughty.
     // we have to queue up a CloseWorker and manually close each of them.
     // the CloseWorker will be invoked once they are all cleaned up
@@ -309,7 +710,7 @@ NAN_METHOD(Database::Close) {
         }
     }
   } else {
-    NanAsyncQueueWorker(worker);
+    database->RunCloseWorker(worker);
   }
 
   NanReturnUndefined();
@@ -322,19 +723,29 @@ NAN_METHOD(Database::Put) {
 
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], key)
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[1], value)
+  LD_CB_ERR_IF_EMPTY(args[0], key)
+  LD_CB_ERR_IF_EMPTY(args[1], value)
 
   v8::Local<v8::Object> keyHandle = args[0].As<v8::Object>();
   v8::Local<v8::Object> valueHandle = args[1].As<v8::Object>();
-  LD_STRING_OR_BUFFER_TO_SLICE(key, keyHandle, key)
-  LD_STRING_OR_BUFFER_TO_SLICE(value, valueHandle, value)
 
   bool sync = NanBooleanOptionValue(optionsObj, NanSymbol("sync"));
 
+  if (database->groupCommit) {
+    // WriteBatch takes its own copy of the data
+    leveldown::Arena arena;
+    database->pendingBatch->Put(
+        StringOrBufferToSlice(keyHandle, arena)
+      , StringOrBufferToSlice(valueHandle, arena)
+    );
+    database->QueueGroupCommit(new NanCallback(callback), sync);
+    NanReturnUndefined();
+  }
+
+  // the worker copies String data into an arena of its own
   WriteWorker* worker  = new WriteWorker(
       database
     , new NanCallback(callback)
-    , key
-    , value
     , sync
     , keyHandle
     , valueHandle
@@ -342,7 +753,7 @@ NAN_METHOD(Database::Put) {
   // persist to prevent accidental GC
   v8::Local<v8::Object> _this = args.This();
   worker->SavePersistent("database", _this);
-  NanAsyncQueueWorker(worker);
+  database->QueueWriteWorker(worker);
 
   NanReturnUndefined();
 }
@@ -353,9 +764,11 @@ NAN_METHOD(Database::Get) {
   LD_METHOD_SETUP_COMMON(get, 1, 2)
 
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], key)
+  LD_SNAPSHOT_FROM_OPTIONS(snapshot, optionsObj)
+
+  LD_CB_ERR_IF_EMPTY(args[0], key)
 
   v8::Local<v8::Object> keyHandle = args[0].As<v8::Object>();
-  LD_STRING_OR_BUFFER_TO_SLICE(key, keyHandle, key)
 
   bool asBuffer = NanBooleanOptionValue(optionsObj, NanSymbol("asBuffer"), true);
   bool fillCache = NanBooleanOptionValue(optionsObj, NanSymbol("fillCache"), true);
@@ -363,15 +776,68 @@ NAN_METHOD(Database::Get) {
   ReadWorker* worker = new ReadWorker(
       database
     , new NanCallback(callback)
-    , key
     , asBuffer
     , fillCache
+    , snapshot
     , keyHandle
   );
   // persist to prevent accidental GC
   v8::Local<v8::Object> _this = args.This();
   worker->SavePersistent("database", _this);
-  NanAsyncQueueWorker(worker);
+  database->QueueReadWorker(worker);
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Database::GetMany) {
+  NanScope();
+
+  LD_METHOD_SETUP_COMMON(getMany, 1, 2)
+
+  if (!args[0]->IsArray()) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "getMany() requires an array of keys")
+  }
+
+  v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(args[0]);
+  uint32_t length = array->Length();
+
+  if (length == 0) {
+    v8::Local<v8::Value> argv[] = {
+        NanNewLocal<v8::Value>(v8::Null())
+      , v8::Array::New(0)
+    };
+    LD_RUN_CALLBACK(callback, 2, argv);
+    NanReturnUndefined();
+  }
+
+  for (uint32_t i = 0; i < length; i++) {
+    LD_CB_ERR_IF_NULL_OR_UNDEFINED(array->Get(i), key)
+    LD_CB_ERR_IF_EMPTY(array->Get(i), key)
+  }
+
+  LD_SNAPSHOT_FROM_OPTIONS(snapshot, optionsObj)
+
+  bool asBuffer = NanBooleanOptionValue(optionsObj, NanSymbol("asBuffer"), true);
+  bool fillCache = NanBooleanOptionValue(optionsObj, NanSymbol("fillCache"), true);
+
+  // take our own copy of the key handles so the caller can't swap them out
+  // from under the worker, Buffer keys are used in place
+  v8::Local<v8::Array> keyHandles = v8::Array::New(length);
+  for (uint32_t i = 0; i < length; i++)
+    keyHandles->Set(i, array->Get(i));
+
+  GetManyWorker* worker = new GetManyWorker(
+      database
+    , new NanCallback(callback)
+    , asBuffer
+    , fillCache
+    , snapshot
+    , keyHandles
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("database", _this);
+  database->QueueReadWorker(worker);
 
   NanReturnUndefined();
 }
@@ -382,27 +848,70 @@ NAN_METHOD(Database::Delete) {
   LD_METHOD_SETUP_COMMON(del, 1, 2)
 
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], key)
+  LD_CB_ERR_IF_EMPTY(args[0], key)
 
   v8::Local<v8::Object> keyHandle = args[0].As<v8::Object>();
-  LD_STRING_OR_BUFFER_TO_SLICE(key, keyHandle, key)
 
   bool sync = NanBooleanOptionValue(optionsObj, NanSymbol("sync"));
 
+  if (database->groupCommit) {
+    leveldown::Arena arena;
+    database->pendingBatch->Delete(StringOrBufferToSlice(keyHandle, arena));
+    database->QueueGroupCommit(new NanCallback(callback), sync);
+    NanReturnUndefined();
+  }
+
   DeleteWorker* worker = new DeleteWorker(
       database
     , new NanCallback(callback)
-    , key
     , sync
     , keyHandle
   );
   // persist to prevent accidental GC
   v8::Local<v8::Object> _this = args.This();
   worker->SavePersistent("database", _this);
-  NanAsyncQueueWorker(worker);
+  database->QueueWriteWorker(worker);
 
   NanReturnUndefined();
 }
 
+// owns the WriteBatches an array batch() fills, its own and one per
+// namespace, until a worker takes them, so every early return frees them
+class PendingBatch {
+public:
+  PendingBatch () : batch(new leveldb::WriteBatch()) {}
+  ~PendingBatch () {
+    delete batch;
+    for (size_t i = 0; i < namespaceBatches.size(); i++)
+      delete namespaceBatches[i].second;
+  }
+
+  // the batch for operations with a `namespace` handle, created on first use
+  leveldb::WriteBatch* NamespaceBatch (Database* ns) {
+    for (size_t i = 0; i < namespaceBatches.size(); i++) {
+      if (namespaceBatches[i].first == ns)
+        return namespaceBatches[i].second;
+    }
+    leveldb::WriteBatch* created = new leveldb::WriteBatch();
+    namespaceBatches.push_back(std::make_pair(ns, created));
+    return created;
+  }
+
+  // hands every batch over to a BatchWorker
+  void Release () {
+    batch = NULL;
+    namespaceBatches.clear();
+  }
+
+  leveldb::WriteBatch* batch;
+  std::vector< std::pair<Database*, leveldb::WriteBatch*> > namespaceBatches;
+
+private:
+  // No copying allowed
+  PendingBatch (const PendingBatch&);
+  void operator= (const PendingBatch&);
+};
+
 NAN_METHOD(Database::Batch) {
   NanScope();
 
@@ -420,8 +929,12 @@ NAN_METHOD(Database::Batch) {
 
   v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(args[0]);
 
-  leveldb::WriteBatch* batch = new leveldb::WriteBatch();
+  // operations with a `namespace` handle go in a batch for that namespace,
+  // written in the same transaction
+  PendingBatch pending;
   bool hasData = false;
+  // one arena for every String in the batch, WriteBatch copies the data
+  leveldown::Arena arena;
 
   for (unsigned int i = 0; i < array->Length(); i++) {
     if (!array->Get(i)->IsObject())
@@ -431,30 +944,41 @@ NAN_METHOD(Database::Batch) {
 
     LD_CB_ERR_IF_NULL_OR_UNDEFINED(obj->Get(NanSymbol("type")), type)
 
+    leveldb::WriteBatch* target = pending.batch;
+    v8::Local<v8::Value> namespaceValue = obj->Get(NanSymbol("namespace"));
+    if (!namespaceValue->IsUndefined() && !namespaceValue->IsNull()) {
+      Database* ns = NULL;
+      if (namespaceValue->IsObject() && NanPersistentToLocal(
+            database_constructor)->HasInstance(namespaceValue)) {
+        ns = node::ObjectWrap::Unwrap<Database>(namespaceValue.As<v8::Object>());
+      }
+      if (ns == NULL || ns->db == NULL || ns->root != database->root) {
+        LD_RETURN_CALLBACK_OR_ERROR(callback
+          , "namespace must be an open namespace of this database")
+      }
+      if (ns != database)
+        target = pending.NamespaceBatch(ns);
+    }
+
     v8::Local<v8::Value> keyBuffer = obj->Get(NanSymbol("key"));
     LD_CB_ERR_IF_NULL_OR_UNDEFINED(keyBuffer, key)
 
     if (obj->Get(NanSymbol("type"))->StrictEquals(NanSymbol("del"))) {
-      LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key)
+      LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key, arena)
 
-      batch->Delete(key);
+      target->Delete(key);
       if (!hasData)
         hasData = true;
-
-      DisposeStringOrBufferFromSlice(keyBuffer, key);
     } else if (obj->Get(NanSymbol("type"))->StrictEquals(NanSymbol("put"))) {
       v8::Local<v8::Value> valueBuffer = obj->Get(NanSymbol("value"));
       LD_CB_ERR_IF_NULL_OR_UNDEFINED(valueBuffer, value)
 
-      LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key)
-      LD_STRING_OR_BUFFER_TO_SLICE(value, valueBuffer, value)
+      LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key, arena)
+      LD_STRING_OR_BUFFER_TO_SLICE(value, valueBuffer, value, arena)
 
-      batch->Put(key, value);
+      target->Put(key, value);
       if (!hasData)
         hasData = true;
-
-      DisposeStringOrBufferFromSlice(keyBuffer, key);
-      DisposeStringOrBufferFromSlice(valueBuffer, value);
     }
   }
 
@@ -463,13 +987,18 @@ NAN_METHOD(Database::Batch) {
     BatchWorker* worker = new BatchWorker(
         database
       , new NanCallback(callback)
-      , batch
+      , pending.batch
       , sync
+      , pending.namespaceBatches
     );
-    // persist to prevent accidental GC
+    pending.Release();
+    // persist to prevent accidental GC, the operations hold on to the
+    // namespace handles
     v8::Local<v8::Object> _this = args.This();
     worker->SavePersistent("database", _this);
-    NanAsyncQueueWorker(worker);
+    v8::Local<v8::Object> operations = array;
+    worker->SavePersistent("operations", operations);
+    database->QueueWriteWorker(worker);
   } else {
     LD_RUN_CALLBACK(callback, 0, NULL);
   }
@@ -477,6 +1006,104 @@ NAN_METHOD(Database::Batch) {
   NanReturnUndefined();
 }
 
+// the header of a packed batch, an 8-byte sequence number followed by a
+// 4-byte count, see deps/wiredtiger-2.2.1/api/leveldb/db/write_batch.cc
+static const size_t kBatchBufferHeader = 12;
+
+NAN_METHOD(Database::BatchBuffer) {
+  NanScope();
+
+  LD_METHOD_SETUP_COMMON(batchBuffer, 1, 2)
+
+  v8::Local<v8::Object> bufferHandle = args[0].As<v8::Object>();
+  if (!node::Buffer::HasInstance(args[0])) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "batchBuffer() requires a Buffer")
+  }
+
+  size_t length = node::Buffer::Length(bufferHandle);
+  if (length < kBatchBufferHeader) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "batchBuffer() Buffer is too short")
+  }
+
+  // don't allow an empty batch through
+  if (length == kBatchBufferHeader) {
+    LD_RUN_CALLBACK(callback, 0, NULL);
+    NanReturnUndefined();
+  }
+
+  bool sync = NanBooleanOptionValue(optionsObj, NanSymbol("sync"));
+
+  leveldb::Slice contents(node::Buffer::Data(bufferHandle), length);
+
+  BatchBufferWorker* worker = new BatchBufferWorker(
+      database
+    , new NanCallback(callback)
+    , contents
+    , sync
+    , bufferHandle
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("database", _this);
+  database->QueueWriteWorker(worker);
+
+  NanReturnUndefined();
+}
+
+// reads range option `name` into `to` unless an earlier option has set it,
+// `inclusive` records whether the key itself is part of the range
+#define LD_CLEAR_RANGE_OPTION(to, hasTo, includeTo, name, inclusive)           \
+  if (!hasTo && optionsObj->Has(NanSymbol(#name))                              \
+      && (node::Buffer::HasInstance(optionsObj->Get(NanSymbol(#name)))         \
+        || optionsObj->Get(NanSymbol(#name))->IsString())) {                   \
+    v8::Local<v8::Value> name ## Handle = optionsObj->Get(NanSymbol(#name));   \
+    LD_STRING_OR_BUFFER_TO_SLICE(_ ## name, name ## Handle, name, arena)       \
+    to = _ ## name;                                                            \
+    hasTo = true;                                                              \
+    includeTo = inclusive;                                                     \
+  }
+
+NAN_METHOD(Database::Clear) {
+  NanScope();
+
+  LD_METHOD_SETUP_COMMON(clear, 0, 1)
+
+  leveldb::Slice begin;
+  leveldb::Slice end;
+  bool hasBegin = false;
+  bool hasEnd = false;
+  bool includeBegin = false;
+  bool includeEnd = false;
+  leveldown::Arena arena;
+
+  if (!optionsObj.IsEmpty()) {
+    // the exclusive bound wins if both are given
+    LD_CLEAR_RANGE_OPTION(begin, hasBegin, includeBegin, gt, false)
+    LD_CLEAR_RANGE_OPTION(begin, hasBegin, includeBegin, gte, true)
+    LD_CLEAR_RANGE_OPTION(end, hasEnd, includeEnd, lt, false)
+    LD_CLEAR_RANGE_OPTION(end, hasEnd, includeEnd, lte, true)
+  }
+
+  bool sync = NanBooleanOptionValue(optionsObj, NanSymbol("sync"));
+
+  // the worker takes its own copy of the range
+  ClearWorker* worker = new ClearWorker(
+      database
+    , new NanCallback(callback)
+    , hasBegin ? &begin : NULL
+    , includeBegin
+    , hasEnd ? &end : NULL
+    , includeEnd
+    , sync
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("database", _this);
+  database->QueueWriteWorker(worker);
+
+  NanReturnUndefined();
+}
+
 NAN_METHOD(Database::ApproximateSize) {
   NanScope();
 
@@ -497,22 +1124,57 @@ NAN_METHOD(Database::ApproximateSize) {
 
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], start)
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[1], end)
-
-  LD_STRING_OR_BUFFER_TO_SLICE(start, startHandle, start)
-  LD_STRING_OR_BUFFER_TO_SLICE(end, endHandle, end)
+  LD_CB_ERR_IF_EMPTY(startHandle, start)
+  LD_CB_ERR_IF_EMPTY(endHandle, end)
 
   ApproximateSizeWorker* worker  = new ApproximateSizeWorker(
       database
     , new NanCallback(callback)
-    , start
-    , end
     , startHandle
     , endHandle
   );
   // persist to prevent accidental GC
   v8::Local<v8::Object> _this = args.This();
   worker->SavePersistent("database", _this);
-  NanAsyncQueueWorker(worker);
+  database->QueueReadWorker(worker);
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Database::CompactRange) {
+  NanScope();
+
+  LD_METHOD_SETUP_COMMON(compactRange, -1, 2)
+
+  // a null or undefined `start` or `end` leaves that end of the range open
+  v8::Local<v8::Object> startHandle = args[0].As<v8::Object>();
+  v8::Local<v8::Object> endHandle = args[1].As<v8::Object>();
+  bool hasStart = !startHandle->IsNull() && !startHandle->IsUndefined();
+  bool hasEnd = !endHandle->IsNull() && !endHandle->IsUndefined();
+
+  leveldb::Slice start;
+  leveldb::Slice end;
+  leveldown::Arena arena;
+  if (hasStart) {
+    LD_STRING_OR_BUFFER_TO_SLICE(_start, startHandle, start, arena)
+    start = _start;
+  }
+  if (hasEnd) {
+    LD_STRING_OR_BUFFER_TO_SLICE(_end, endHandle, end, arena)
+    end = _end;
+  }
+
+  // the worker takes its own copy of the range
+  CompactRangeWorker* worker = new CompactRangeWorker(
+      database
+    , new NanCallback(callback)
+    , hasStart ? &start : NULL
+    , hasEnd ? &end : NULL
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("database", _this);
+  database->QueueWriteWorker(worker);
 
   NanReturnUndefined();
 }
@@ -528,7 +1190,8 @@ NAN_METHOD(Database::GetProperty) {
 
   LD_CB_ERR_IF_NULL_OR_UNDEFINED(propertyHandle, property)
 
-  LD_STRING_OR_BUFFER_TO_SLICE(property, propertyHandle, property)
+  leveldown::Arena arena;
+  LD_STRING_OR_BUFFER_TO_SLICE(property, propertyHandle, property, arena)
 
   leveldown::Database* database =
       node::ObjectWrap::Unwrap<leveldown::Database>(args.This());
@@ -538,11 +1201,295 @@ NAN_METHOD(Database::GetProperty) {
   v8::Local<v8::String> returnValue
       = v8::String::New(value->c_str(), value->length());
   delete value;
-  delete[] property.data();
 
   NanReturnValue(returnValue);
 }
 
+static v8::Local<v8::Object> PoolStatsObject (WorkerPool* pool) {
+  uint32_t threads = 0;
+  uint32_t queued = 0;
+  uint32_t active = 0;
+  if (pool != NULL) {
+    threads = pool->Size();
+    pool->Stats(&queued, &active);
+  }
+
+  v8::Local<v8::Object> obj = v8::Object::New();
+  obj->Set(NanSymbol("threads"), v8::Integer::NewFromUnsigned(threads));
+  obj->Set(NanSymbol("queued"), v8::Integer::NewFromUnsigned(queued));
+  obj->Set(NanSymbol("active"), v8::Integer::NewFromUnsigned(active));
+  return obj;
+}
+
+NAN_METHOD(Database::PoolStats) {
+  NanScope();
+
+  leveldown::Database* database =
+      node::ObjectWrap::Unwrap<leveldown::Database>(args.This());
+
+  v8::Local<v8::Object> returnValue = v8::Object::New();
+  returnValue->Set(NanSymbol("read"),
+      PoolStatsObject(database->root->readPool));
+  returnValue->Set(NanSymbol("write"),
+      PoolStatsObject(database->root->writePool));
+
+  NanReturnValue(returnValue);
+}
+
+/* Synchronous methods, these block the main thread *****************************/
+
+#define LD_SYNC_METHOD_SETUP(name, optionPos)                                  \
+  leveldown::Database* database =                                              \
+    node::ObjectWrap::Unwrap<leveldown::Database>(args.This());                \
+  v8::Local<v8::Function> callback; /* empty, errors are thrown */             \
+  if (database->db == NULL)                                                    \
+    return NanThrowError(#name "() requires an open database");                \
+  v8::Local<v8::Object> optionsObj;                                            \
+  if (args.Length() > optionPos && args[optionPos]->IsObject())                \
+    optionsObj = args[optionPos].As<v8::Object>();
+
+NAN_METHOD(Database::GetSync) {
+  NanScope();
+
+  LD_SYNC_METHOD_SETUP(getSync, 1)
+
+  if (args.Length() == 0)
+    return NanThrowError("getSync() requires a key argument");
+  LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], key)
+  LD_SNAPSHOT_FROM_OPTIONS(snapshot, optionsObj)
+
+  v8::Local<v8::Object> keyHandle = args[0].As<v8::Object>();
+  leveldown::Arena arena;
+  LD_STRING_OR_BUFFER_TO_SLICE(key, keyHandle, key, arena)
+
+  bool asBuffer = NanBooleanOptionValue(optionsObj, NanSymbol("asBuffer"), true);
+  bool fillCache = NanBooleanOptionValue(optionsObj, NanSymbol("fillCache"), true);
+
+  leveldb::ReadOptions options;
+  options.fill_cache = fillCache;
+  if (snapshot != NULL)
+    options.snapshot = snapshot->DbSnapshot();
+  char* value = NULL;
+  size_t valueSize = 0;
+  leveldb::Status status =
+      database->GetFromDatabase(&options, key, &value, &valueSize);
+
+  if (status.IsNotFound())
+    NanReturnUndefined();
+  if (!status.ok())
+    return NanThrowError(status.ToString().c_str());
+
+  v8::Local<v8::Value> returnValue;
+  if (asBuffer) {
+    // the Buffer takes ownership of the value, no copy
+    returnValue = NanNewBufferHandle(value, valueSize, FreeValue, NULL);
+  } else {
+    returnValue = v8::String::New(value, valueSize);
+    delete[] value;
+  }
+
+  NanReturnValue(returnValue);
+}
+
+NAN_METHOD(Database::PutSync) {
+  NanScope();
+
+  LD_SYNC_METHOD_SETUP(putSync, 2)
+
+  if (args.Length() < 2)
+    return NanThrowError("putSync() requires key and value arguments");
+  LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[0], key)
+  LD_CB_ERR_IF_NULL_OR_UNDEFINED(args[1], value)
+
+  v8::Local<v8::Object> keyHandle = args[0].As<v8::Object>();
+  v8::Local<v8::Object> valueHandle = args[1].As<v8::Object>();
+  leveldown::Arena arena;
+  LD_STRING_OR_BUFFER_TO_SLICE(key, keyHandle, key, arena)
+  LD_STRING_OR_BUFFER_TO_SLICE(value, valueHandle, value, arena)
+
+  leveldb::WriteOptions options;
+  options.sync = NanBooleanOptionValue(optionsObj, NanSymbol("sync"));
+  leveldb::Status status = database->PutToDatabase(&options, key, value);
+
+  if (!status.ok())
+    return NanThrowError(status.ToString().c_str());
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Database::BatchSync) {
+  NanScope();
+
+  LD_SYNC_METHOD_SETUP(batchSync, 1)
+
+  if (args.Length() == 0 || !args[0]->IsArray())
+    return NanThrowError("batchSync() requires an array of operations");
+
+  v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(args[0]);
+
+  leveldb::WriteBatch batch;
+  bool hasData = false;
+  leveldown::Arena arena;
+
+  for (unsigned int i = 0; i < array->Length(); i++) {
+    if (!array->Get(i)->IsObject())
+      continue;
+
+    v8::Local<v8::Object> obj = v8::Local<v8::Object>::Cast(array->Get(i));
+
+    LD_CB_ERR_IF_NULL_OR_UNDEFINED(obj->Get(NanSymbol("type")), type)
+
+    v8::Local<v8::Value> keyBuffer = obj->Get(NanSymbol("key"));
+    LD_CB_ERR_IF_NULL_OR_UNDEFINED(keyBuffer, key)
+
+    if (obj->Get(NanSymbol("type"))->StrictEquals(NanSymbol("del"))) {
+      LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key, arena)
+
+      batch.Delete(key);
+      hasData = true;
+    } else if (obj->Get(NanSymbol("type"))->StrictEquals(NanSymbol("put"))) {
+      v8::Local<v8::Value> valueBuffer = obj->Get(NanSymbol("value"));
+      LD_CB_ERR_IF_NULL_OR_UNDEFINED(valueBuffer, value)
+
+      LD_STRING_OR_BUFFER_TO_SLICE(key, keyBuffer, key, arena)
+      LD_STRING_OR_BUFFER_TO_SLICE(value, valueBuffer, value, arena)
+
+      batch.Put(key, value);
+      hasData = true;
+    }
+  }
+
+  if (hasData) {
+    leveldb::WriteOptions options;
+    options.sync = NanBooleanOptionValue(optionsObj, NanSymbol("sync"));
+    leveldb::Status status = database->WriteBatchToDatabase(&options, &batch);
+    if (!status.ok())
+      return NanThrowError(status.ToString().c_str());
+  }
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Database::Snapshot) {
+  NanScope();
+
+  Database* database = node::ObjectWrap::Unwrap<Database>(args.This());
+
+  if (database->db == NULL)
+    return NanThrowError("snapshot() requires an open database");
+
+  v8::Local<v8::Object> snapshotHandle =
+      leveldown::Snapshot::NewInstance(args.This());
+  leveldown::Snapshot* snapshot =
+      node::ObjectWrap::Unwrap<leveldown::Snapshot>(snapshotHandle);
+  // every session the database may open (see sessionMax) is in use
+  if (snapshot->DbSnapshot() == NULL)
+    return NanThrowError("snapshot() cannot open a session");
+  database->snapshots.insert(snapshot);
+
+  NanReturnValue(snapshotHandle);
+}
+
+NAN_METHOD(Database::BulkLoader) {
+  NanScope();
+
+  Database* database = node::ObjectWrap::Unwrap<Database>(args.This());
+
+  if (database->db == NULL)
+    return NanThrowError("bulkLoader() requires an open database");
+
+  leveldb::BulkLoader* loader;
+  leveldb::Status status = database->NewBulkLoader(&loader);
+  if (!status.ok())
+    return NanThrowError(status.ToString().c_str());
+
+  v8::Local<v8::Object> bulkLoaderHandle =
+      leveldown::BulkLoader::NewInstance(args.This());
+  leveldown::BulkLoader* bulkLoader =
+      node::ObjectWrap::Unwrap<leveldown::BulkLoader>(bulkLoaderHandle);
+  bulkLoader->loader = loader;
+  database->bulkLoaders.insert(bulkLoader);
+
+  NanReturnValue(bulkLoaderHandle);
+}
+
+NAN_METHOD(Database::Namespace) {
+  NanScope();
+
+  Database* database = node::ObjectWrap::Unwrap<Database>(args.This());
+
+  if (database->db == NULL)
+    return NanThrowError("namespace() requires an open database");
+
+  if (args.Length() == 0 || !args[0]->IsString())
+    return NanThrowError("namespace() requires a name string argument");
+
+  v8::Local<v8::Object> optionsObj;
+  if (args.Length() > 1 && args[1]->IsObject()) {
+    optionsObj = args[1].As<v8::Object>();
+  }
+
+  // table settings, used if the namespace is created
+  const leveldb::FilterPolicy* filterPolicy =
+      leveldb::NewBloomFilterPolicy(10);
+  leveldb::Options options;
+  options.filter_policy = filterPolicy;
+  options.create_if_missing = NanBooleanOptionValue(
+      optionsObj
+    , NanSymbol("createIfMissing")
+    , true
+  );
+  options.compression =
+      NanBooleanOptionValue(optionsObj, NanSymbol("compression"), true)
+        ? leveldb::kSnappyCompression
+        : leveldb::kNoCompression;
+  options.write_buffer_size = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("writeBufferSize")
+    , 4 << 20
+  );
+  options.block_size = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("blockSize")
+    , 4096
+  );
+  leveldb::WiredTigerOptions wtOptions;
+  wtOptions.table_type =
+      StringOptionValue(optionsObj, NanSymbol("engine"), "lsm");
+  wtOptions.table_config = StringOptionValue(
+      WiredTigerOptionsObject(optionsObj)
+    , NanSymbol("table")
+    , ""
+  );
+
+  char* name = NanFromV8String(args[0].As<v8::Object>(), Nan::UTF8, NULL, NULL, 0, v8::String::NO_OPTIONS);
+  leveldb::WiredTigerDB* namespaceDb;
+  leveldb::Status status =
+      database->db->OpenNamespace(options, wtOptions, name, &namespaceDb);
+  delete[] name;
+  delete filterPolicy;
+  if (!status.ok())
+    return NanThrowError(status.ToString().c_str());
+
+  v8::Local<v8::String> location = v8::String::New(database->location);
+  v8::Local<v8::Object> namespaceHandle =
+      Database::NewInstance(location)->ToObject();
+  Database* ns = node::ObjectWrap::Unwrap<Database>(namespaceHandle);
+  ns->db = namespaceDb;
+  ns->root = database->root;
+  ns->SetGroupCommit(
+      database->root->groupCommit
+    , database->root->groupCommitWindow
+  );
+  database->root->namespaces.insert(ns);
+  v8::Local<v8::Object> rootObj = database->root == database
+      ? args.This()
+      : NanPersistentToLocal(database->rootHandle);
+  NanAssignPersistent(v8::Object, ns->rootHandle, rootObj);
+
+  NanReturnValue(namespaceHandle);
+}
+
 NAN_METHOD(Database::Iterator) {
   NanScope();
 
@@ -553,6 +1500,9 @@ NAN_METHOD(Database::Iterator) {
     optionsObj = v8::Local<v8::Object>::Cast(args[0]);
   }
 
+  v8::Local<v8::Function> callback; // for LD_SNAPSHOT_FROM_OPTIONS
+  LD_SNAPSHOT_FROM_OPTIONS(snapshot, optionsObj)
+
   // each iterator gets a unique id for this Database, so we can
   // easily store & lookup on our `iterators` map
   uint32_t id = database->currentIteratorId++;
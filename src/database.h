@@ -7,12 +7,15 @@
 #define LD_DATABASE_H
 
 #include <map>
+#include <set>
 #include <vector>
 #include <node.h>
 
 #include "leveldb/cache.h"
 #include "leveldb/db.h"
 #include "leveldb/filter_policy.h"
+#include "leveldb/write_batch.h"
+#include "leveldb_wt_db.h"
 #include "nan.h"
 #include "wiredtigerdown.h"
 #include "iterator.h"
@@ -21,33 +24,21 @@ namespace leveldown {
 
 NAN_METHOD(LevelDOWN);
 
-struct Reference {
-  v8::Persistent<v8::Object> handle;
-  leveldb::Slice slice;
-
-  Reference(v8::Local<v8::Value> obj, leveldb::Slice slice) : slice(slice) {
-    v8::Local<v8::Object> _obj = v8::Object::New();
-    _obj->Set(NanSymbol("obj"), obj);
-    NanAssignPersistent(v8::Object, handle, _obj);
-  };
-};
-
-static inline void ClearReferences (std::vector<Reference *> *references) {
-  for (std::vector<Reference *>::iterator it = references->begin()
-      ; it != references->end()
-      ; ) {
-    DisposeStringOrBufferFromSlice((*it)->handle, (*it)->slice);
-    it = references->erase(it);
-  }
-  delete references;
-}
+class AsyncWorker;
+class WorkerPool;
+class Snapshot;
+class BulkLoader;
 
 class Database : public node::ObjectWrap {
 public:
   static void Init ();
   static v8::Handle<v8::Value> NewInstance (v8::Local<v8::String> &location);
 
-  leveldb::Status OpenDatabase (leveldb::Options* options, std::string location);
+  leveldb::Status OpenDatabase (
+      leveldb::Options* options
+    , leveldb::WiredTigerOptions* wtOptions
+    , std::string location
+  );
   leveldb::Status PutToDatabase (
       leveldb::WriteOptions* options
     , leveldb::Slice key
@@ -56,7 +47,14 @@ public:
   leveldb::Status GetFromDatabase (
       leveldb::ReadOptions* options
     , leveldb::Slice key
-    , std::string& value
+    , char** value
+    , size_t* valueSize
+  );
+  leveldb::Status GetManyFromDatabase (
+      leveldb::ReadOptions* options
+    , const std::vector<leveldb::Slice>& keys
+    , char** values
+    , size_t* valueSizes
   );
   leveldb::Status DeleteFromDatabase (
       leveldb::WriteOptions* options
@@ -66,30 +64,104 @@ public:
       leveldb::WriteOptions* options
     , leveldb::WriteBatch* batch
   );
+  leveldb::Status WriteBatchesToDatabase (
+      leveldb::WriteOptions* options
+    , leveldb::WriteBatch* batch
+    , const std::vector< std::pair<Database*, leveldb::WriteBatch*> >& namespaceBatches
+  );
+  leveldb::Status WriteBufferToDatabase (
+      leveldb::WriteOptions* options
+    , leveldb::Slice contents
+  );
+  leveldb::Status ClearFromDatabase (
+      leveldb::WriteOptions* options
+    , const leveldb::Slice* begin
+    , bool includeBegin
+    , const leveldb::Slice* end
+    , bool includeEnd
+  );
+  leveldb::Status CompactRangeFromDatabase (
+      const leveldb::Slice* start
+    , const leveldb::Slice* end
+    , leveldb::CompactionStats* stats
+  );
   uint64_t ApproximateSizeFromDatabase (const leveldb::Range* range);
   void GetPropertyFromDatabase (const leveldb::Slice& property, std::string* value);
-  leveldb::Iterator* NewIterator (leveldb::ReadOptions* options);
+  leveldb::Iterator* NewIterator (
+      leveldb::ReadOptions* options
+    , const leveldb::IteratorBounds& bounds
+  );
   const leveldb::Snapshot* NewSnapshot ();
   void ReleaseSnapshot (const leveldb::Snapshot* snapshot);
+  void ForgetSnapshot (leveldown::Snapshot* snapshot);
+  leveldb::Status NewBulkLoader (leveldb::BulkLoader** loader);
+  void ForgetBulkLoader (leveldown::BulkLoader* bulkLoader);
+  void ForgetNamespace (Database* ns);
   void CloseDatabase ();
   const char* Location() const;
   void ReleaseIterator (uint32_t id);
+  void QueueReadWorker (AsyncWorker* worker);
+  void QueueWriteWorker (AsyncWorker* worker);
+  void QueueBulkLoadWorker (AsyncWorker* worker);
+  void ReleaseBulkLoadWorker ();
+  void QueueGroupCommit (NanCallback* callback, bool sync);
+  void FlushGroupCommit ();
+  void ReleaseGroupCommit ();
 
   Database (char* location);
   ~Database ();
 
+  // the database opened with open(), for namespace handles the one they
+  // were opened through
+  Database* root;
+
 private:
-  leveldb::DB* db;
+  leveldb::WiredTigerDB* db;
   const leveldb::FilterPolicy* filterPolicy;
   leveldb::Cache* blockCache;
   char* location;
   uint32_t currentIteratorId;
   void(*pendingCloseWorker);
 
+  // a namespace handle keeps the database it was opened through alive
+  v8::Persistent<v8::Object> rootHandle;
+  // on the root, the namespace handles not yet closed, close() fails while
+  // there are any; namespace handles queue their work on the root's pools
+  std::set< Database * > namespaces;
+
   std::map< uint32_t, leveldown::Iterator * > iterators;
+  std::set< leveldown::Snapshot * > snapshots;
+  std::set< leveldown::BulkLoader * > bulkLoaders;
+  // loads still running at close(), finished before the database closes
+  std::vector< leveldb::BulkLoader * > closingLoaders;
+  // bulk load write() and finish() calls a CloseWorker has to wait for
+  uint32_t bulkLoadsInFlight;
+
+  // group commit state, put() and del() calls are gathered into
+  // pendingBatch until groupCommitTimer fires
+  bool groupCommit;
+  uint64_t groupCommitWindow;
+  uv_timer_t* groupCommitTimer;
+  bool groupCommitScheduled;
+  leveldb::WriteBatch* pendingBatch;
+  bool pendingSync;
+  std::vector<NanCallback*> pendingCallbacks;
+  uint32_t groupCommitsInFlight;
+
+  // optional dedicated thread pools, NULL means the libuv thread pool
+  WorkerPool* readPool;
+  WorkerPool* writePool;
+  // pools still running their queues at close(), the CloseWorker waits
+  uint32_t poolsStopping;
+  AsyncWorker* stoppingCloseWorker;
+
+  void SetGroupCommit (bool enabled, uint64_t window);
+  void RunCloseWorker (AsyncWorker* worker);
+  static void PoolStopped (void* arg);
 
   static void WriteDoing(uv_work_t *req);
   static void WriteAfter(uv_work_t *req);
+  static void GroupCommitTimeout(uv_timer_t *handle, int status);
 
   static NAN_METHOD(New);
   static NAN_METHOD(Open);
@@ -97,11 +169,22 @@ private:
   static NAN_METHOD(Put);
   static NAN_METHOD(Delete);
   static NAN_METHOD(Get);
+  static NAN_METHOD(GetMany);
   static NAN_METHOD(Batch);
   static NAN_METHOD(Write);
+  static NAN_METHOD(BatchBuffer);
+  static NAN_METHOD(Clear);
   static NAN_METHOD(Iterator);
+  static NAN_METHOD(Snapshot);
+  static NAN_METHOD(BulkLoader);
+  static NAN_METHOD(Namespace);
   static NAN_METHOD(ApproximateSize);
+  static NAN_METHOD(CompactRange);
   static NAN_METHOD(GetProperty);
+  static NAN_METHOD(PoolStats);
+  static NAN_METHOD(GetSync);
+  static NAN_METHOD(PutSync);
+  static NAN_METHOD(BatchSync);
 };
 
 } // namespace leveldown
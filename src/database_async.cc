@@ -3,6 +3,7 @@
  * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
  */
 
+#include <algorithm>
 #include <node.h>
 #include <node_buffer.h>
 
@@ -16,6 +17,11 @@
 
 namespace leveldown {
 
+// frees a value handed over to a Buffer without copying
+void FreeValue (char* data, void* hint) {
+  delete[] data;
+}
+
 /** OPEN WORKER **/
 
 OpenWorker::OpenWorker (
@@ -30,6 +36,15 @@ OpenWorker::OpenWorker (
   , uint32_t blockSize
   , uint32_t maxOpenFiles
   , uint32_t blockRestartInterval
+  , uint32_t sessionCacheSize
+  , uint32_t sessionMax
+  , const std::string& statistics
+  , const std::string& engine
+  , const std::string& connectionConfig
+  , const std::string& tableConfig
+  , const std::string& sharedCache
+  , size_t sharedCacheSize
+  , size_t sharedCacheReserve
 ) : AsyncWorker(database, callback)
 {
   options = new leveldb::Options();
@@ -44,14 +59,26 @@ OpenWorker::OpenWorker (
   options->block_size             = blockSize;
   options->max_open_files         = maxOpenFiles;
   options->block_restart_interval = blockRestartInterval;
+
+  wtOptions = new leveldb::WiredTigerOptions();
+  wtOptions->session_cache_size   = sessionCacheSize;
+  wtOptions->session_max          = sessionMax;
+  wtOptions->statistics           = statistics;
+  wtOptions->table_type           = engine;
+  wtOptions->connection_config    = connectionConfig;
+  wtOptions->table_config         = tableConfig;
+  wtOptions->shared_cache         = sharedCache;
+  wtOptions->shared_cache_size    = sharedCacheSize;
+  wtOptions->shared_cache_reserve = sharedCacheReserve;
 };
 
 OpenWorker::~OpenWorker () {
   delete options;
+  delete wtOptions;
 }
 
 void OpenWorker::Execute () {
-  SetStatus(database->OpenDatabase(options, database->Location()));
+  SetStatus(database->OpenDatabase(options, wtOptions, database->Location()));
 }
 
 /** CLOSE WORKER **/
@@ -70,6 +97,9 @@ void CloseWorker::Execute () {
 
 void CloseWorker::WorkComplete () {
   NanScope();
+  // a closed namespace no longer holds up close() on its database
+  if (database->root != database)
+    database->root->ForgetNamespace(database);
   HandleOKCallback();
   delete callback;
   callback = NULL;
@@ -80,50 +110,53 @@ void CloseWorker::WorkComplete () {
 IOWorker::IOWorker (
     Database *database
   , NanCallback *callback
-  , leveldb::Slice key
   , v8::Local<v8::Object> &keyHandle
 ) : AsyncWorker(database, callback)
-  , key(key)
 {
   NanScope();
 
+  key = StringOrBufferToSlice(keyHandle, arena);
   SavePersistent("key", keyHandle);
 };
 
 IOWorker::~IOWorker () {}
 
-void IOWorker::WorkComplete () {
-  NanScope();
-
-  DisposeStringOrBufferFromSlice(GetFromPersistent("key"), key);
-  AsyncWorker::WorkComplete();
-}
-
 /** READ WORKER **/
 
 ReadWorker::ReadWorker (
     Database *database
   , NanCallback *callback
-  , leveldb::Slice key
   , bool asBuffer
   , bool fillCache
+  , Snapshot* snapshot
   , v8::Local<v8::Object> &keyHandle
-) : IOWorker(database, callback, key, keyHandle)
+) : IOWorker(database, callback, keyHandle)
   , asBuffer(asBuffer)
+  , snapshot(snapshot)
+  , value(NULL)
+  , valueSize(0)
 {
   NanScope();
 
   options = new leveldb::ReadOptions();
   options->fill_cache = fillCache;
+  if (snapshot != NULL) {
+    options->snapshot = snapshot->DbSnapshot();
+    snapshot->Pin();
+  }
   SavePersistent("key", keyHandle);
 };
 
 ReadWorker::~ReadWorker () {
   delete options;
+  if (snapshot != NULL)
+    snapshot->Unpin();
+  if (value != NULL)
+    delete[] value;
 }
 
 void ReadWorker::Execute () {
-  SetStatus(database->GetFromDatabase(options, key, value));
+  SetStatus(database->GetFromDatabase(options, key, &value, &valueSize));
 }
 
 void ReadWorker::HandleOKCallback () {
@@ -131,9 +164,11 @@ void ReadWorker::HandleOKCallback () {
 
   v8::Local<v8::Value> returnValue;
   if (asBuffer) {
-    returnValue = NanNewBufferHandle((char*)value.data(), value.size());
+    // the Buffer takes ownership of the value, no copy
+    returnValue = NanNewBufferHandle(value, valueSize, FreeValue, NULL);
+    value = NULL;
   } else {
-    returnValue = v8::String::New((char*)value.data(), value.size());
+    returnValue = v8::String::New(value, valueSize);
   }
   v8::Local<v8::Value> argv[] = {
       NanNewLocal<v8::Value>(v8::Null())
@@ -142,15 +177,129 @@ void ReadWorker::HandleOKCallback () {
   callback->Call(2, argv);
 }
 
+/** GET MANY WORKER **/
+
+// orders indexes into a key list by the keys they point at
+class KeyIndexComparator {
+public:
+  KeyIndexComparator (const std::vector<leveldb::Slice>& keys) : keys(keys) {}
+
+  bool operator() (size_t a, size_t b) const {
+    return keys[a].compare(keys[b]) < 0;
+  }
+
+private:
+  const std::vector<leveldb::Slice>& keys;
+};
+
+GetManyWorker::GetManyWorker (
+    Database *database
+  , NanCallback *callback
+  , bool asBuffer
+  , bool fillCache
+  , Snapshot* snapshot
+  , v8::Local<v8::Array> &keyHandles
+) : AsyncWorker(database, callback)
+  , asBuffer(asBuffer)
+  , snapshot(snapshot)
+  , values(keyHandles->Length(), (char*)NULL)
+  , valueSizes(keyHandles->Length(), 0)
+{
+  NanScope();
+
+  // Strings share the worker's arena, Buffer keys are used in place
+  uint32_t length = keyHandles->Length();
+  keys.reserve(length);
+  for (uint32_t i = 0; i < length; i++)
+    keys.push_back(StringOrBufferToSlice(keyHandles->Get(i), arena));
+
+  options = new leveldb::ReadOptions();
+  options->fill_cache = fillCache;
+  if (snapshot != NULL) {
+    options->snapshot = snapshot->DbSnapshot();
+    snapshot->Pin();
+  }
+  v8::Local<v8::Object> obj = keyHandles;
+  SavePersistent("keys", obj);
+};
+
+GetManyWorker::~GetManyWorker () {
+  delete options;
+  if (snapshot != NULL)
+    snapshot->Unpin();
+  for (size_t i = 0; i < values.size(); i++) {
+    if (values[i] != NULL)
+      delete[] values[i];
+  }
+}
+
+void GetManyWorker::Execute () {
+  // look the keys up in key order with one session and cursor checked out
+  // for the whole call, so successive searches come down through the same
+  // internal pages and mostly land on leaf pages that are already hot,
+  // results go back in the caller's order
+  size_t size = keys.size();
+  std::vector<size_t> order(size);
+  for (size_t i = 0; i < size; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), KeyIndexComparator(keys));
+
+  std::vector<leveldb::Slice> sortedKeys(size);
+  for (size_t i = 0; i < size; i++)
+    sortedKeys[i] = keys[order[i]];
+  std::vector<char*> sortedValues(size, (char*)NULL);
+  std::vector<size_t> sortedSizes(size, 0);
+
+  leveldb::Status status = database->GetManyFromDatabase(
+      options
+    , sortedKeys
+    , &sortedValues[0]
+    , &sortedSizes[0]
+  );
+
+  // hand over whatever was found, even on error, so it's freed with the
+  // worker
+  for (size_t i = 0; i < size; i++) {
+    values[order[i]] = sortedValues[i];
+    valueSizes[order[i]] = sortedSizes[i];
+  }
+  SetStatus(status);
+}
+
+void GetManyWorker::HandleOKCallback () {
+  NanScope();
+
+  // keys that weren't found are left `undefined`
+  uint32_t size = values.size();
+  v8::Local<v8::Array> returnValues = v8::Array::New(size);
+  for (uint32_t i = 0; i < size; i++) {
+    if (values[i] == NULL)
+      continue;
+    if (asBuffer) {
+      // the Buffer takes ownership of the value, no copy
+      returnValues->Set(i
+        , NanNewBufferHandle(values[i], valueSizes[i], FreeValue, NULL));
+      values[i] = NULL;
+    } else {
+      returnValues->Set(i, v8::String::New(values[i], valueSizes[i]));
+    }
+  }
+
+  v8::Local<v8::Value> argv[] = {
+      NanNewLocal<v8::Value>(v8::Null())
+    , returnValues
+  };
+  callback->Call(2, argv);
+}
+
 /** DELETE WORKER **/
 
 DeleteWorker::DeleteWorker (
     Database *database
   , NanCallback *callback
-  , leveldb::Slice key
   , bool sync
   , v8::Local<v8::Object> &keyHandle
-) : IOWorker(database, callback, key, keyHandle)
+) : IOWorker(database, callback, keyHandle)
 {
   NanScope();
 
@@ -172,16 +321,14 @@ void DeleteWorker::Execute () {
 WriteWorker::WriteWorker (
     Database *database
   , NanCallback *callback
-  , leveldb::Slice key
-  , leveldb::Slice value
   , bool sync
   , v8::Local<v8::Object> &keyHandle
   , v8::Local<v8::Object> &valueHandle
-) : DeleteWorker(database, callback, key, sync, keyHandle)
-  , value(value)
+) : DeleteWorker(database, callback, sync, keyHandle)
 {
   NanScope();
 
+  value = StringOrBufferToSlice(valueHandle, arena);
   SavePersistent("value", valueHandle);
 };
 
@@ -192,14 +339,6 @@ void WriteWorker::Execute () {
   //printf("WriteWorker::Execute\n");fflush(stdout);
 }
 
-void WriteWorker::WorkComplete () {
-  NanScope();
-
-  DisposeStringOrBufferFromSlice(GetFromPersistent("value"), value);
-  IOWorker::WorkComplete();
-  //printf("WriteWorker::WorkComplete\n");fflush(stdout);
-}
-
 /** BATCH WORKER **/
 
 BatchWorker::BatchWorker (
@@ -207,8 +346,10 @@ BatchWorker::BatchWorker (
   , NanCallback *callback
   , leveldb::WriteBatch* batch
   , bool sync
+  , const std::vector< std::pair<Database*, leveldb::WriteBatch*> >& namespaceBatches
 ) : AsyncWorker(database, callback)
   , batch(batch)
+  , namespaceBatches(namespaceBatches)
 {
   options = new leveldb::WriteOptions();
   options->sync = sync;
@@ -216,27 +357,145 @@ BatchWorker::BatchWorker (
 
 BatchWorker::~BatchWorker () {
   delete batch;
+  for (size_t i = 0; i < namespaceBatches.size(); i++)
+    delete namespaceBatches[i].second;
   delete options;
 }
 
 void BatchWorker::Execute () {
+  if (namespaceBatches.empty()) {
+    SetStatus(database->WriteBatchToDatabase(options, batch));
+  } else {
+    SetStatus(database->WriteBatchesToDatabase(
+        options
+      , batch
+      , namespaceBatches
+    ));
+  }
+}
+
+/** BATCH BUFFER WORKER **/
+
+BatchBufferWorker::BatchBufferWorker (
+    Database *database
+  , NanCallback *callback
+  , leveldb::Slice contents
+  , bool sync
+  , v8::Local<v8::Object> &bufferHandle
+) : AsyncWorker(database, callback)
+  , contents(contents)
+{
+  NanScope();
+
+  options = new leveldb::WriteOptions();
+  options->sync = sync;
+  // the records are read straight out of the Buffer
+  SavePersistent("buffer", bufferHandle);
+};
+
+BatchBufferWorker::~BatchBufferWorker () {
+  delete options;
+}
+
+void BatchBufferWorker::Execute () {
+  SetStatus(database->WriteBufferToDatabase(options, contents));
+}
+
+/** CLEAR WORKER **/
+
+ClearWorker::ClearWorker (
+    Database *database
+  , NanCallback *callback
+  , const leveldb::Slice* begin
+  , bool includeBegin
+  , const leveldb::Slice* end
+  , bool includeEnd
+  , bool sync
+) : AsyncWorker(database, callback)
+  , hasBegin(begin != NULL)
+  , hasEnd(end != NULL)
+  , includeBegin(includeBegin)
+  , includeEnd(includeEnd)
+{
+  options = new leveldb::WriteOptions();
+  options->sync = sync;
+  if (hasBegin)
+    this->begin.assign(begin->data(), begin->size());
+  if (hasEnd)
+    this->end.assign(end->data(), end->size());
+};
+
+ClearWorker::~ClearWorker () {
+  delete options;
+}
+
+void ClearWorker::Execute () {
+  leveldb::Slice begin(this->begin);
+  leveldb::Slice end(this->end);
+  SetStatus(database->ClearFromDatabase(
+      options
+    , hasBegin ? &begin : NULL
+    , includeBegin
+    , hasEnd ? &end : NULL
+    , includeEnd
+  ));
+}
+
+/** GROUP COMMIT WORKER **/
+
+GroupCommitWorker::GroupCommitWorker (
+    Database *database
+  , leveldb::WriteBatch* batch
+  , std::vector<NanCallback*>& callbacks
+  , bool sync
+) : AsyncWorker(database, NULL)
+  , batch(batch)
+  , callbacks(callbacks)
+{
+  options = new leveldb::WriteOptions();
+  options->sync = sync;
+};
+
+GroupCommitWorker::~GroupCommitWorker () {
+  delete batch;
+  delete options;
+  for (size_t i = 0; i < callbacks.size(); i++)
+    delete callbacks[i];
+}
+
+void GroupCommitWorker::Execute () {
   SetStatus(database->WriteBatchToDatabase(options, batch));
 }
 
+void GroupCommitWorker::WorkComplete () {
+  NanScope();
+
+  database->ReleaseGroupCommit();
+
+  // fan the result of the one write back out to every caller
+  v8::Local<v8::Value> argv[1];
+  int argc = 0;
+  if (errmsg != NULL) {
+    argv[0] = v8::Exception::Error(v8::String::New(errmsg));
+    argc = 1;
+  }
+  for (size_t i = 0; i < callbacks.size(); i++)
+    callbacks[i]->Call(argc, argv);
+}
+
 /** APPROXIMATE SIZE WORKER **/
 
 ApproximateSizeWorker::ApproximateSizeWorker (
     Database *database
   , NanCallback *callback
-  , leveldb::Slice start
-  , leveldb::Slice end
   , v8::Local<v8::Object> &startHandle
   , v8::Local<v8::Object> &endHandle
 ) : AsyncWorker(database, callback)
-  , range(start, end)
 {
   NanScope();
 
+  range.start = StringOrBufferToSlice(startHandle, arena);
+  range.limit = StringOrBufferToSlice(endHandle, arena);
   SavePersistent("start", startHandle);
   SavePersistent("end", endHandle);
 };
@@ -247,18 +506,59 @@ void ApproximateSizeWorker::Execute () {
   size = database->ApproximateSizeFromDatabase(&range);
 }
 
-void ApproximateSizeWorker::WorkComplete() {
+void ApproximateSizeWorker::HandleOKCallback () {
   NanScope();
 
-  DisposeStringOrBufferFromSlice(GetFromPersistent("start"), range.start);
-  DisposeStringOrBufferFromSlice(GetFromPersistent("end"), range.limit);
-  AsyncWorker::WorkComplete();
+  v8::Local<v8::Value> returnValue = v8::Number::New((double) size);
+  v8::Local<v8::Value> argv[] = {
+      NanNewLocal<v8::Value>(v8::Null())
+    , returnValue
+  };
+  callback->Call(2, argv);
 }
 
-void ApproximateSizeWorker::HandleOKCallback () {
+/** COMPACT RANGE WORKER **/
+
+CompactRangeWorker::CompactRangeWorker (
+    Database *database
+  , NanCallback *callback
+  , const leveldb::Slice* start
+  , const leveldb::Slice* end
+) : AsyncWorker(database, callback)
+  , hasStart(start != NULL)
+  , hasEnd(end != NULL)
+{
+  if (hasStart)
+    this->start.assign(start->data(), start->size());
+  if (hasEnd)
+    this->end.assign(end->data(), end->size());
+};
+
+CompactRangeWorker::~CompactRangeWorker () {}
+
+void CompactRangeWorker::Execute () {
+  leveldb::Slice start(this->start);
+  leveldb::Slice end(this->end);
+  SetStatus(database->CompactRangeFromDatabase(
+      hasStart ? &start : NULL
+    , hasEnd ? &end : NULL
+    , &stats
+  ));
+}
+
+void CompactRangeWorker::HandleOKCallback () {
   NanScope();
 
-  v8::Local<v8::Value> returnValue = v8::Number::New((double) size);
+  // merging can leave more files than it found if writes come in meanwhile
+  int merged = stats.files_before - stats.files_after;
+  double reclaimed = (double) stats.bytes_before - (double) stats.bytes_after;
+  v8::Local<v8::Object> returnValue = v8::Object::New();
+  returnValue->Set(NanSymbol("chunksMerged"),
+      v8::Number::New(merged > 0 ? merged : 0));
+  returnValue->Set(NanSymbol("bytesReclaimed"),
+      v8::Number::New(reclaimed > 0 ? reclaimed : 0));
+  returnValue->Set(NanSymbol("filesCompacted"),
+      v8::Number::New(stats.files_compacted));
   v8::Local<v8::Value> argv[] = {
       NanNewLocal<v8::Value>(v8::Null())
     , returnValue
@@ -12,9 +12,12 @@
 #include "leveldb/cache.h"
 
 #include "async.h"
+#include "snapshot.h"
 
 namespace leveldown {
 
+void FreeValue (char* data, void* hint);
+
 class OpenWorker : public AsyncWorker {
 public:
   OpenWorker (
@@ -29,6 +32,15 @@ public:
     , uint32_t blockSize
     , uint32_t maxOpenFiles
     , uint32_t blockRestartInterval
+    , uint32_t sessionCacheSize
+    , uint32_t sessionMax
+    , const std::string& statistics
+    , const std::string& engine
+    , const std::string& connectionConfig
+    , const std::string& tableConfig
+    , const std::string& sharedCache
+    , size_t sharedCacheSize
+    , size_t sharedCacheReserve
   );
 
   virtual ~OpenWorker ();
@@ -36,6 +48,7 @@ public:
 
 private:
   leveldb::Options* options;
+  leveldb::WiredTigerOptions* wtOptions;
 };
 
 class CloseWorker : public AsyncWorker {
@@ -55,14 +68,13 @@ public:
   IOWorker (
       Database *database
     , NanCallback *callback
-    , leveldb::Slice key
     , v8::Local<v8::Object> &keyHandle
   );
 
   virtual ~IOWorker ();
-  virtual void WorkComplete ();
 
 protected:
+  Arena arena;
   leveldb::Slice key;
 };
 
@@ -71,9 +83,9 @@ public:
   ReadWorker (
       Database *database
     , NanCallback *callback
-    , leveldb::Slice key
     , bool asBuffer
     , bool fillCache
+    , Snapshot* snapshot
     , v8::Local<v8::Object> &keyHandle
   );
 
@@ -84,7 +96,34 @@ public:
 private:
   bool asBuffer;
   leveldb::ReadOptions* options;
-  std::string value;
+  Snapshot* snapshot;
+  char* value;
+  size_t valueSize;
+};
+
+class GetManyWorker : public AsyncWorker {
+public:
+  GetManyWorker (
+      Database *database
+    , NanCallback *callback
+    , bool asBuffer
+    , bool fillCache
+    , Snapshot* snapshot
+    , v8::Local<v8::Array> &keyHandles
+  );
+
+  virtual ~GetManyWorker ();
+  virtual void Execute ();
+  virtual void HandleOKCallback ();
+
+private:
+  bool asBuffer;
+  leveldb::ReadOptions* options;
+  Snapshot* snapshot;
+  Arena arena;
+  std::vector<leveldb::Slice> keys;
+  std::vector<char*> values;
+  std::vector<size_t> valueSizes;
 };
 
 class DeleteWorker : public IOWorker {
@@ -92,7 +131,6 @@ public:
   DeleteWorker (
       Database *database
     , NanCallback *callback
-    , leveldb::Slice key
     , bool sync
     , v8::Local<v8::Object> &keyHandle
   );
@@ -109,8 +147,6 @@ public:
   WriteWorker (
       Database *database
     , NanCallback *callback
-    , leveldb::Slice key
-    , leveldb::Slice value
     , bool sync
     , v8::Local<v8::Object> &keyHandle
     , v8::Local<v8::Object> &valueHandle
@@ -118,7 +154,6 @@ public:
 
   virtual ~WriteWorker ();
   virtual void Execute ();
-  virtual void WorkComplete ();
 
 private:
   leveldb::Slice value;
@@ -131,6 +166,8 @@ public:
     , NanCallback *callback
     , leveldb::WriteBatch* batch
     , bool sync
+    , const std::vector< std::pair<Database*, leveldb::WriteBatch*> >& namespaceBatches
+        = std::vector< std::pair<Database*, leveldb::WriteBatch*> >()
   );
 
   virtual ~BatchWorker ();
@@ -139,6 +176,69 @@ public:
 private:
   leveldb::WriteOptions* options;
   leveldb::WriteBatch* batch;
+  std::vector< std::pair<Database*, leveldb::WriteBatch*> > namespaceBatches;
+};
+
+class BatchBufferWorker : public AsyncWorker {
+public:
+  BatchBufferWorker (
+      Database *database
+    , NanCallback *callback
+    , leveldb::Slice contents
+    , bool sync
+    , v8::Local<v8::Object> &bufferHandle
+  );
+
+  virtual ~BatchBufferWorker ();
+  virtual void Execute ();
+
+private:
+  leveldb::WriteOptions* options;
+  leveldb::Slice contents;
+};
+
+class ClearWorker : public AsyncWorker {
+public:
+  ClearWorker (
+      Database *database
+    , NanCallback *callback
+    , const leveldb::Slice* begin
+    , bool includeBegin
+    , const leveldb::Slice* end
+    , bool includeEnd
+    , bool sync
+  );
+
+  virtual ~ClearWorker ();
+  virtual void Execute ();
+
+private:
+  leveldb::WriteOptions* options;
+  std::string begin;
+  std::string end;
+  bool hasBegin;
+  bool hasEnd;
+  bool includeBegin;
+  bool includeEnd;
+};
+
+class GroupCommitWorker : public AsyncWorker {
+public:
+  GroupCommitWorker (
+      Database *database
+    , leveldb::WriteBatch* batch
+    , std::vector<NanCallback*>& callbacks
+    , bool sync
+  );
+
+  virtual ~GroupCommitWorker ();
+  virtual void Execute ();
+  virtual void WorkComplete ();
+
+private:
+  leveldb::WriteOptions* options;
+  leveldb::WriteBatch* batch;
+  std::vector<NanCallback*> callbacks;
 };
 
 class ApproximateSizeWorker : public AsyncWorker {
@@ -146,8 +246,6 @@ public:
   ApproximateSizeWorker (
       Database *database
     , NanCallback *callback
-    , leveldb::Slice start
-    , leveldb::Slice end
     , v8::Local<v8::Object> &startHandle
     , v8::Local<v8::Object> &endHandle
   );
@@ -155,13 +253,34 @@ public:
   virtual ~ApproximateSizeWorker ();
   virtual void Execute ();
   virtual void HandleOKCallback ();
-  virtual void WorkComplete ();
 
   private:
+    Arena arena;
     leveldb::Range range;
     uint64_t size;
 };
 
+class CompactRangeWorker : public AsyncWorker {
+public:
+  CompactRangeWorker (
+      Database *database
+    , NanCallback *callback
+    , const leveldb::Slice* start
+    , const leveldb::Slice* end
+  );
+
+  virtual ~CompactRangeWorker ();
+  virtual void Execute ();
+  virtual void HandleOKCallback ();
+
+private:
+  std::string start;
+  std::string end;
+  bool hasStart;
+  bool hasEnd;
+  leveldb::CompactionStats stats;
+};
+
 } // namespace leveldown
 
 #endif
@@ -3,17 +3,23 @@
  * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
  */
 
+#include <algorithm>
 #include <node.h>
 #include <node_buffer.h>
 
 #include "database.h"
 #include "iterator.h"
 #include "iterator_async.h"
+#include "snapshot.h"
 
 namespace leveldown {
 
 static v8::Persistent<v8::FunctionTemplate> iterator_constructor;
 
+static void CloseDeliverTimer (uv_handle_t* handle) {
+  delete (uv_timer_t*)handle;
+}
+
 Iterator::Iterator (
     Database* database
   , uint32_t id
@@ -30,7 +36,12 @@ Iterator::Iterator (
   , bool fillCache
   , bool keyAsBuffer
   , bool valueAsBuffer
+  , bool readAhead
+  , uint32_t readAheadEntries
+  , uint32_t readAheadBytes
+  , Snapshot* snapshot
   , v8::Local<v8::Object> &startHandle
+  , std::string* startKey
 ) : database(database)
   , id(id)
   , start(start)
@@ -43,6 +54,11 @@ Iterator::Iterator (
   , lte(lte)
   , gt(gt)
   , gte(gte)
+  , startKey(startKey)
+  , snapshot(snapshot)
+  , readAhead(readAhead)
+  , readAheadEntries(readAheadEntries)
+  , readAheadBytes(readAheadBytes)
   , keyAsBuffer(keyAsBuffer)
   , valueAsBuffer(valueAsBuffer)
 {
@@ -55,11 +71,23 @@ Iterator::Iterator (
 
   options    = new leveldb::ReadOptions();
   options->fill_cache = fillCache;
+  if (snapshot != NULL) {
+    options->snapshot = snapshot->DbSnapshot();
+    snapshot->Pin();
+  }
   dbIterator = NULL;
-  count      = 0;
   nexting    = false;
   ended      = false;
   endWorker  = NULL;
+
+  bufferedBytes   = 0;
+  filling         = false;
+  exhausted       = false;
+  pendingCallback = NULL;
+  pendingBatch    = false;
+  pendingLimit    = 0;
+  pendingBytes    = 0;
+  deliverTimer    = NULL;
 };
 
 Iterator::~Iterator () {
@@ -70,88 +98,120 @@ Iterator::~Iterator () {
     delete start;
   if (end != NULL)
     delete end;
+  if (lt != NULL)
+    delete lt;
+  if (lte != NULL)
+    delete lte;
+  if (gt != NULL)
+    delete gt;
+  if (gte != NULL)
+    delete gte;
+  if (startKey != NULL)
+    delete startKey;
+  if (snapshot != NULL)
+    snapshot->Unpin();
+  if (pendingCallback != NULL)
+    delete pendingCallback;
+  if (deliverTimer != NULL)
+    uv_close((uv_handle_t*)deliverTimer, CloseDeliverTimer);
 };
 
-bool Iterator::GetIterator () {
-  if (dbIterator == NULL) {
-    dbIterator = database->NewIterator(options);
-
-    if (start != NULL) {
-      dbIterator->Seek(*start);
-
-      if (reverse) {
-        if (!dbIterator->Valid()) {
-          // if it's past the last key, step back
-          dbIterator->SeekToLast();
-        } else {
-          std::string key_ = dbIterator->key().ToString();
-
-          if (lt != NULL) {
-            if (lt->compare(key_) <= 0)
-              dbIterator->Prev();
-          } else if (lte != NULL) {
-            if (lte->compare(key_) < 0)
-              dbIterator->Prev();
-          } else if (start != NULL) {
-            if (start->compare(key_))
-              dbIterator->Prev();
-          }
-        }
-
-        if (dbIterator->Valid() && lt != NULL) {
-          if (lt->compare(dbIterator->key().ToString()) <= 0)
-            dbIterator->Prev();
-        }
-      } else {
-        if (dbIterator->Valid() && gt != NULL
-            && gt->compare(dbIterator->key().ToString()) == 0)
-          dbIterator->Next();
-      }
-    } else if (reverse) {
-      dbIterator->SeekToLast();
-    } else {
-      dbIterator->SeekToFirst();
+// narrows one end of the range to `bound` unless it's already as tight, on
+// a tie the exclusive bound wins
+static void NarrowRange (
+      leveldb::Slice& to
+    , bool& has
+    , bool& inclusive
+    , const leveldb::Slice& bound
+    , bool boundInclusive
+    , bool upper
+    ) {
+  if (has) {
+    int cmp = bound.compare(to);
+    if (cmp == 0) {
+      inclusive = inclusive && boundInclusive;
+      return;
     }
+    if (upper ? cmp > 0 : cmp < 0)
+      return;
+  }
+  to = bound;
+  has = true;
+  inclusive = boundInclusive;
+}
 
-    return true;
+bool Iterator::GetIterator () {
+  if (dbIterator != NULL)
+    return false;
+
+  // the engine iterator checks the bounds and limit itself, comparing
+  // each key in place instead of copying it out to compare here
+  leveldb::Slice lower;
+  leveldb::Slice upper;
+  bool hasLower = false;
+  bool hasUpper = false;
+  bool lowerInclusive = true;
+  bool upperInclusive = true;
+
+  // `start` is where iteration begins unless gt/gte (or lt/lte when
+  // reversed) replaced it, `end` is where it stops
+  if (gt != NULL)
+    NarrowRange(lower, hasLower, lowerInclusive, *gt, false, false);
+  else if (gte != NULL)
+    NarrowRange(lower, hasLower, lowerInclusive, *gte, true, false);
+  else if (!reverse && start != NULL)
+    NarrowRange(lower, hasLower, lowerInclusive, *start, true, false);
+
+  if (lt != NULL)
+    NarrowRange(upper, hasUpper, upperInclusive, *lt, false, true);
+  else if (lte != NULL)
+    NarrowRange(upper, hasUpper, upperInclusive, *lte, true, true);
+  else if (reverse && start != NULL)
+    NarrowRange(upper, hasUpper, upperInclusive, *start, true, true);
+
+  if (end != NULL) {
+    if (reverse)
+      NarrowRange(lower, hasLower, lowerInclusive, *end, true, false);
+    else
+      NarrowRange(upper, hasUpper, upperInclusive, *end, true, true);
   }
-  return false;
+
+  leveldb::IteratorBounds bounds;
+  bounds.lower           = hasLower ? &lower : NULL;
+  bounds.lower_inclusive = lowerInclusive;
+  bounds.upper           = hasUpper ? &upper : NULL;
+  bounds.upper_inclusive = upperInclusive;
+  bounds.limit           = limit;
+
+  dbIterator = database->NewIterator(options, bounds);
+  if (reverse)
+    dbIterator->SeekToLast();
+  else
+    dbIterator->SeekToFirst();
+
+  return true;
 }
 
 bool Iterator::IteratorNext (std::string& key, std::string& value) {
   // if it's not the first call, move to next item.
   if (!GetIterator()) {
+    // already past the end of the range or the limit
+    if (!dbIterator->Valid())
+      return false;
     if (reverse)
       dbIterator->Prev();
     else
       dbIterator->Next();
   }
 
-  // now check if this is the end or not, if not then return the key & value
-  if (dbIterator->Valid()) {
-    std::string key_ = dbIterator->key().ToString();
-    int isEnd = end == NULL ? 1 : end->compare(key_);
-
-    if ((limit < 0 || ++count <= limit)
-      && (end == NULL
-          || (reverse && (isEnd <= 0))
-          || (!reverse && (isEnd >= 0)))
-      && ( lt  != NULL ? (lt->compare(key_) > 0)
-         : lte != NULL ? (lte->compare(key_) >= 0)
-         : true )
-      && ( gt  != NULL ? (gt->compare(key_) < 0)
-         : gte != NULL ? (gte->compare(key_) <= 0)
-         : true )
-    ) {
-      if (keys)
-        key.assign(dbIterator->key().data(), dbIterator->key().size());
-      if (values)
-        value.assign(dbIterator->value().data(), dbIterator->value().size());
-      return true;
-    }
-  }
+  if (!dbIterator->Valid())
+    return false;
 
-  return false;
+  if (keys)
+    key.assign(dbIterator->key().data(), dbIterator->key().size());
+  if (values)
+    value.assign(dbIterator->value().data(), dbIterator->value().size());
+  return true;
 }
 
 leveldb::Status Iterator::IteratorStatus () {
@@ -165,13 +225,187 @@ void Iterator::IteratorEnd () {
 }
 
 void Iterator::Release () {
+  // the cursor is gone, the snapshot can be released
+  if (snapshot != NULL) {
+    snapshot->Unpin();
+    snapshot = NULL;
+  }
   database->ReleaseIterator(id);
 }
 
+void Iterator::QueueWorker (AsyncWorker* worker) {
+  database->QueueReadWorker(worker);
+}
+
+/* Read-ahead, main thread only *****************************/
+
+static v8::Local<v8::Value> EntryHandle (const std::string& data, bool asBuffer) {
+  if (asBuffer)
+    return NanNewBufferHandle((char*)data.data(), data.size());
+  return v8::String::New((char*)data.data(), data.size());
+}
+
+void Iterator::WaitForReadAhead (
+      v8::Local<v8::Function> callback
+    , bool batch
+    , uint32_t limit
+    , uint32_t highWaterMarkBytes
+    ) {
+  pendingCallback = new NanCallback(callback);
+  pendingBatch    = batch;
+  pendingLimit    = limit;
+  pendingBytes    = highWaterMarkBytes;
+  nexting         = true;
+  // keep ourselves alive until the callback has been called
+  Ref();
+
+  StartReadAhead();
+
+  if (!bufferedKeys.empty() || exhausted) {
+    // already have something to hand out, but never call back
+    // synchronously, do it on the next turn of the loop
+    if (deliverTimer == NULL) {
+      deliverTimer = new uv_timer_t;
+      uv_timer_init(uv_default_loop(), deliverTimer);
+      deliverTimer->data = this;
+    }
+    uv_timer_start(deliverTimer, DeliverTimeout, 0, 0);
+  }
+  // otherwise ReadAheadComplete() will deliver
+}
+
+void Iterator::DeliverTimeout (uv_timer_t* handle, int status) {
+  NanScope();
+
+  Iterator* iterator = static_cast<Iterator*>(handle->data);
+  iterator->DeliverReadAhead();
+}
+
+void Iterator::StartReadAhead () {
+  if (filling || exhausted || ended)
+    return;
+  if (bufferedKeys.size() >= readAheadEntries
+      || bufferedBytes >= readAheadBytes)
+    return;
+
+  // fill in chunks of a quarter of the buffer so the first entries get
+  // to JS early and the cursor is kept busy as JS drains the buffer
+  uint32_t entries = std::min(
+      readAheadEntries - (uint32_t)bufferedKeys.size()
+    , std::max(readAheadEntries / 4, 1u)
+  );
+  uint32_t bytes = std::min(
+      readAheadBytes - (uint32_t)bufferedBytes
+    , std::max(readAheadBytes / 4, 1u)
+  );
+
+  ReadAheadWorker* worker = new ReadAheadWorker(this, entries, bytes);
+  filling = true;
+  Ref();
+  QueueWorker(worker);
+}
+
+void Iterator::ReadAheadComplete (
+      std::vector<std::string>& keys
+    , std::vector<std::string>& values
+    , bool done
+    , leveldb::Status status
+    ) {
+  filling = false;
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    bufferedKeys.push_back(std::string());
+    bufferedKeys.back().swap(keys[i]);
+    bufferedValues.push_back(std::string());
+    bufferedValues.back().swap(values[i]);
+    bufferedBytes += bufferedKeys.back().size() + bufferedValues.back().size();
+  }
+  if (done) {
+    exhausted = true;
+    readAheadStatus = status;
+  }
+
+  DeliverReadAhead();
+  StartReadAhead();
+  CheckEnd();
+
+  Unref();
+}
+
+void Iterator::DeliverReadAhead () {
+  if (pendingCallback == NULL)
+    return;
+  if (bufferedKeys.empty() && !exhausted)
+    return; // wait for the fill in flight
+
+  NanScope();
+
+  NanCallback* callback = pendingCallback;
+  pendingCallback = NULL;
+  nexting = false;
+
+  v8::Local<v8::Value> argv[3];
+  int argc = 0;
+
+  if (bufferedKeys.empty() && !readAheadStatus.ok()) {
+    argv[0] = v8::Exception::Error(
+        v8::String::New(readAheadStatus.ToString().c_str()));
+    argc = 1;
+  } else if (pendingBatch) {
+    uint32_t size = 0;
+    size_t bytes = 0;
+    while (size < bufferedKeys.size() && size < pendingLimit
+        && bytes < pendingBytes) {
+      bytes += bufferedKeys[size].size() + bufferedValues[size].size();
+      size++;
+    }
+
+    v8::Local<v8::Array> returnKeys = v8::Array::New(size);
+    v8::Local<v8::Array> returnValues = v8::Array::New(size);
+    for (uint32_t i = 0; i < size; i++) {
+      returnKeys->Set(i, EntryHandle(bufferedKeys.front(), keyAsBuffer));
+      returnValues->Set(i, EntryHandle(bufferedValues.front(), valueAsBuffer));
+      bufferedKeys.pop_front();
+      bufferedValues.pop_front();
+    }
+    bufferedBytes -= bytes;
+
+    argv[0] = NanNewLocal<v8::Value>(v8::Null());
+    argv[1] = returnKeys;
+    argv[2] = returnValues;
+    argc = 3;
+  } else if (!bufferedKeys.empty()) {
+    argv[0] = NanNewLocal<v8::Value>(v8::Null());
+    argv[1] = EntryHandle(bufferedKeys.front(), keyAsBuffer);
+    argv[2] = EntryHandle(bufferedValues.front(), valueAsBuffer);
+    argc = 3;
+    bufferedBytes -= bufferedKeys.front().size() + bufferedValues.front().size();
+    bufferedKeys.pop_front();
+    bufferedValues.pop_front();
+  }
+  // else the end of the iterator, call back with no arguments
+
+  // room has been made, keep the buffer topped up
+  StartReadAhead();
+  CheckEnd();
+
+  callback->Call(argc, argv);
+  delete callback;
+
+  Unref();
+}
+
+void Iterator::CheckEnd () {
+  if (endWorker != NULL && !nexting && !filling) {
+    QueueWorker(endWorker);
+    endWorker = NULL;
+  }
+}
+
 void checkEndCallback (Iterator* iterator) {
   iterator->nexting = false;
   if (iterator->endWorker != NULL) {
-    NanAsyncQueueWorker(iterator->endWorker);
+    iterator->QueueWorker(iterator->endWorker);
     iterator->endWorker = NULL;
   }
 }
@@ -194,6 +428,11 @@ NAN_METHOD(Iterator::Next) {
     LD_RETURN_CALLBACK_OR_ERROR(callback, "cannot call next() before previous next() has completed")
   }
 
+  if (iterator->readAhead) {
+    iterator->WaitForReadAhead(callback, false, 1, 0);
+    NanReturnValue(args.Holder());
+  }
+
   NextWorker* worker = new NextWorker(
       iterator
     , new NanCallback(callback)
@@ -203,7 +442,68 @@ NAN_METHOD(Iterator::Next) {
   v8::Local<v8::Object> _this = args.This();
   worker->SavePersistent("iterator", _this);
   iterator->nexting = true;
-  NanAsyncQueueWorker(worker);
+  iterator->QueueWorker(worker);
+
+  NanReturnValue(args.Holder());
+}
+
+NAN_METHOD(Iterator::NextBatch) {
+  NanScope();
+
+  Iterator* iterator = node::ObjectWrap::Unwrap<Iterator>(args.This());
+
+  v8::Local<v8::Object> optionsObj;
+  v8::Local<v8::Function> callback;
+  if (args.Length() > 0 && args[0]->IsFunction()) {
+    callback = args[0].As<v8::Function>();
+  } else if (args.Length() > 1 && args[0]->IsObject() && args[1]->IsFunction()) {
+    optionsObj = args[0].As<v8::Object>();
+    callback = args[1].As<v8::Function>();
+  } else {
+    return NanThrowError("nextBatch() requires a callback argument");
+  }
+
+  if (iterator->ended) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "cannot call nextBatch() after end()")
+  }
+
+  if (iterator->nexting) {
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "cannot call nextBatch() before previous next() has completed")
+  }
+
+  uint32_t limit = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("limit")
+    , 1000
+  );
+  uint32_t highWaterMarkBytes = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("highWaterMarkBytes")
+    , 64 * 1024
+  );
+
+  if (iterator->readAhead) {
+    iterator->WaitForReadAhead(
+        callback
+      , true
+      , limit > 0 ? limit : 1
+      , highWaterMarkBytes
+    );
+    NanReturnValue(args.Holder());
+  }
+
+  NextBatchWorker* worker = new NextBatchWorker(
+      iterator
+    , new NanCallback(callback)
+    , checkEndCallback
+    , limit > 0 ? limit : 1
+    , highWaterMarkBytes
+  );
+  // persist to prevent accidental GC
+  v8::Local<v8::Object> _this = args.This();
+  worker->SavePersistent("iterator", _this);
+  iterator->nexting = true;
+  iterator->QueueWorker(worker);
 
   NanReturnValue(args.Holder());
 }
@@ -231,11 +531,11 @@ NAN_METHOD(Iterator::End) {
   worker->SavePersistent("iterator", _this);
   iterator->ended = true;
 
-  if (iterator->nexting) {
-    // waiting for a next() to return, queue the end
+  if (iterator->nexting || iterator->filling) {
+    // waiting for a next() or a read-ahead to return, queue the end
     iterator->endWorker = worker;
   } else {
-    NanAsyncQueueWorker(worker);
+    iterator->QueueWorker(worker);
   }
 
   NanReturnValue(args.Holder());
@@ -248,6 +548,7 @@ void Iterator::Init () {
   tpl->SetClassName(NanSymbol("Iterator"));
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
   NODE_SET_PROTOTYPE_METHOD(tpl, "next", Iterator::Next);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "nextBatch", Iterator::NextBatch);
   NODE_SET_PROTOTYPE_METHOD(tpl, "end", Iterator::End);
 }
 
@@ -304,6 +605,10 @@ NAN_METHOD(Iterator::New) {
   //default to forward.
   bool reverse = false;
 
+  // the range options are copied out of the arena before it goes away
+  leveldown::Arena arena;
+  std::string* startKey = NULL;
+
   if (args.Length() > 1 && args[2]->IsObject()) {
     optionsObj = v8::Local<v8::Object>::Cast(args[2]);
 
@@ -317,8 +622,9 @@ NAN_METHOD(Iterator::New) {
 
       // ignore start if it has size 0 since a Slice can't have length 0
       if (StringOrBufferLength(startHandle) > 0) {
-        LD_STRING_OR_BUFFER_TO_SLICE(_start, startHandle, start)
-        start = new leveldb::Slice(_start.data(), _start.size());
+        LD_STRING_OR_BUFFER_TO_SLICE(_start, startHandle, start, arena)
+        startKey = new std::string(_start.data(), _start.size());
+        start = new leveldb::Slice(startKey->data(), startKey->size());
       }
     }
 
@@ -331,7 +637,7 @@ NAN_METHOD(Iterator::New) {
 
       // ignore end if it has size 0 since a Slice can't have length 0
       if (StringOrBufferLength(endBuffer) > 0) {
-        LD_STRING_OR_BUFFER_TO_SLICE(_end, endBuffer, end)
+        LD_STRING_OR_BUFFER_TO_SLICE(_end, endBuffer, end, arena)
         end = new std::string(_end.data(), _end.size());
       }
     }
@@ -350,10 +656,13 @@ NAN_METHOD(Iterator::New) {
 
       // ignore end if it has size 0 since a Slice can't have length 0
       if (StringOrBufferLength(ltBuffer) > 0) {
-        LD_STRING_OR_BUFFER_TO_SLICE(_lt, ltBuffer, lt)
+        LD_STRING_OR_BUFFER_TO_SLICE(_lt, ltBuffer, lt, arena)
         lt = new std::string(_lt.data(), _lt.size());
-        if (reverse)
-          start = new leveldb::Slice(_lt.data(), _lt.size());
+        if (reverse) {
+          if (start != NULL)
+            delete start;
+          start = new leveldb::Slice(lt->data(), lt->size());
+        }
       }
     }
 
@@ -366,10 +675,13 @@ NAN_METHOD(Iterator::New) {
 
       // ignore end if it has size 0 since a Slice can't have length 0
       if (StringOrBufferLength(lteBuffer) > 0) {
-        LD_STRING_OR_BUFFER_TO_SLICE(_lte, lteBuffer, lte)
+        LD_STRING_OR_BUFFER_TO_SLICE(_lte, lteBuffer, lte, arena)
         lte = new std::string(_lte.data(), _lte.size());
-        if (reverse)
-          start = new leveldb::Slice(_lte.data(), _lte.size());
+        if (reverse) {
+          if (start != NULL)
+            delete start;
+          start = new leveldb::Slice(lte->data(), lte->size());
+        }
       }
     }
 
@@ -382,10 +694,13 @@ NAN_METHOD(Iterator::New) {
 
       // ignore end if it has size 0 since a Slice can't have length 0
       if (StringOrBufferLength(gtBuffer) > 0) {
-        LD_STRING_OR_BUFFER_TO_SLICE(_gt, gtBuffer, gt)
+        LD_STRING_OR_BUFFER_TO_SLICE(_gt, gtBuffer, gt, arena)
         gt = new std::string(_gt.data(), _gt.size());
-        if (!reverse)
-          start = new leveldb::Slice(_gt.data(), _gt.size());
+        if (!reverse) {
+          if (start != NULL)
+            delete start;
+          start = new leveldb::Slice(gt->data(), gt->size());
+        }
       }
     }
 
@@ -398,10 +713,13 @@ NAN_METHOD(Iterator::New) {
 
       // ignore end if it has size 0 since a Slice can't have length 0
       if (StringOrBufferLength(gteBuffer) > 0) {
-        LD_STRING_OR_BUFFER_TO_SLICE(_gte, gteBuffer, gte)
+        LD_STRING_OR_BUFFER_TO_SLICE(_gte, gteBuffer, gte, arena)
         gte = new std::string(_gte.data(), _gte.size());
-        if (!reverse)
-          start = new leveldb::Slice(_gte.data(), _gte.size());
+        if (!reverse) {
+          if (start != NULL)
+            delete start;
+          start = new leveldb::Slice(gte->data(), gte->size());
+        }
       }
     }
 
@@ -420,6 +738,19 @@ NAN_METHOD(Iterator::New) {
     , true
   );
   bool fillCache = NanBooleanOptionValue(optionsObj, NanSymbol("fillCache"));
+  bool readAhead = NanBooleanOptionValue(optionsObj, NanSymbol("readAhead"));
+  // checked by Database::Iterator
+  Snapshot* snapshot = Snapshot::FromOptions(optionsObj);
+  uint32_t readAheadEntries = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("readAheadEntries")
+    , 10000
+  );
+  uint32_t readAheadBytes = NanUInt32OptionValue(
+      optionsObj
+    , NanSymbol("readAheadBytes")
+    , 1024 * 1024
+  );
 
   Iterator* iterator = new Iterator(
       database
@@ -437,7 +768,12 @@ NAN_METHOD(Iterator::New) {
     , fillCache
     , keyAsBuffer
     , valueAsBuffer
+    , readAhead
+    , readAheadEntries > 0 ? readAheadEntries : 1
+    , readAheadBytes > 0 ? readAheadBytes : 1
+    , snapshot
     , startHandle
+    , startKey
   );
   iterator->Wrap(args.This());
 
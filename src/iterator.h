@@ -6,6 +6,8 @@
 #ifndef LD_ITERATOR_H
 #define LD_ITERATOR_H
 
+#include <deque>
+#include <vector>
 #include <node.h>
 
 #include "nan.h"
@@ -17,6 +19,7 @@ namespace leveldown {
 
 class Database;
 class AsyncWorker;
+class Snapshot;
 
 class Iterator : public node::ObjectWrap {
 public:
@@ -43,7 +46,12 @@ public:
     , bool fillCache
     , bool keyAsBuffer
     , bool valueAsBuffer
+    , bool readAhead
+    , uint32_t readAheadEntries
+    , uint32_t readAheadBytes
+    , Snapshot* snapshot
     , v8::Local<v8::Object> &startHandle
+    , std::string* startKey
   );
 
   ~Iterator ();
@@ -52,6 +60,13 @@ public:
   leveldb::Status IteratorStatus ();
   void IteratorEnd ();
   void Release ();
+  void QueueWorker (AsyncWorker* worker);
+  void ReadAheadComplete (
+      std::vector<std::string>& keys
+    , std::vector<std::string>& values
+    , bool done
+    , leveldb::Status status
+  );
 
 private:
   Database* database;
@@ -68,7 +83,27 @@ private:
   std::string* lte;
   std::string* gt;
   std::string* gte;
-  int count;
+  // the iterator's copy of the `start` option
+  std::string* startKey;
+  Snapshot* snapshot;
+
+  // read-ahead, main thread only: a ReadAheadWorker keeps topping up
+  // the buffered entries while JS consumes them
+  bool readAhead;
+  uint32_t readAheadEntries;
+  uint32_t readAheadBytes;
+  std::deque<std::string> bufferedKeys;
+  std::deque<std::string> bufferedValues;
+  size_t bufferedBytes;
+  bool filling;
+  bool exhausted;
+  leveldb::Status readAheadStatus;
+  // the next() or nextBatch() waiting on the buffer
+  NanCallback* pendingCallback;
+  bool pendingBatch;
+  uint32_t pendingLimit;
+  uint32_t pendingBytes;
+  uv_timer_t* deliverTimer;
 
 public:
   bool keyAsBuffer;
@@ -81,9 +116,21 @@ private:
   v8::Persistent<v8::Object> persistentHandle;
 
   bool GetIterator ();
+  void WaitForReadAhead (
+      v8::Local<v8::Function> callback
+    , bool batch
+    , uint32_t limit
+    , uint32_t highWaterMarkBytes
+  );
+  void StartReadAhead ();
+  void DeliverReadAhead ();
+  void CheckEnd ();
+
+  static void DeliverTimeout (uv_timer_t* handle, int status);
 
   static NAN_METHOD(New);
   static NAN_METHOD(Next);
+  static NAN_METHOD(NextBatch);
   static NAN_METHOD(End);
 };
 
@@ -64,6 +64,125 @@ void NextWorker::HandleOKCallback () {
   }
 }
 
+/** NEXT BATCH WORKER **/
+
+NextBatchWorker::NextBatchWorker (
+    Iterator* iterator
+  , NanCallback *callback
+  , void (*localCallback)(Iterator*)
+  , uint32_t limit
+  , uint32_t highWaterMarkBytes
+) : AsyncWorker(NULL, callback)
+  , iterator(iterator)
+  , localCallback(localCallback)
+  , limit(limit)
+  , highWaterMarkBytes(highWaterMarkBytes)
+{};
+
+NextBatchWorker::~NextBatchWorker () {}
+
+void NextBatchWorker::Execute () {
+  // walk the iterator until we have `limit` entries or have buffered at
+  // least `highWaterMarkBytes`, all within this one threadpool job
+  size_t bytes = 0;
+  keys.reserve(limit);
+  values.reserve(limit);
+  while (keys.size() < limit && bytes < highWaterMarkBytes) {
+    keys.push_back(std::string());
+    values.push_back(std::string());
+    if (!iterator->IteratorNext(keys.back(), values.back())) {
+      keys.pop_back();
+      values.pop_back();
+      SetStatus(iterator->IteratorStatus());
+      break;
+    }
+    bytes += keys.back().size() + values.back().size();
+  }
+}
+
+void NextBatchWorker::HandleOKCallback () {
+  NanScope();
+
+  uint32_t size = keys.size();
+  v8::Local<v8::Array> returnKeys = v8::Array::New(size);
+  v8::Local<v8::Array> returnValues = v8::Array::New(size);
+
+  for (uint32_t i = 0; i < size; i++) {
+    const std::string& key = keys[i];
+    const std::string& value = values[i];
+
+    if (iterator->keyAsBuffer) {
+      returnKeys->Set(i, NanNewBufferHandle((char*)key.data(), key.size()));
+    } else {
+      returnKeys->Set(i, v8::String::New((char*)key.data(), key.size()));
+    }
+
+    if (iterator->valueAsBuffer) {
+      returnValues->Set(i
+        , NanNewBufferHandle((char*)value.data(), value.size()));
+    } else {
+      returnValues->Set(i, v8::String::New((char*)value.data(), value.size()));
+    }
+  }
+
+  // clean up & handle the next/end state see iterator.cc/checkEndCallback
+  localCallback(iterator);
+
+  v8::Local<v8::Value> argv[] = {
+      NanNewLocal<v8::Value>(v8::Null())
+    , returnKeys
+    , returnValues
+  };
+  callback->Call(3, argv);
+}
+
+void NextBatchWorker::HandleErrorCallback () {
+  NanScope();
+
+  localCallback(iterator);
+  AsyncWorker::HandleErrorCallback();
+}
+
+/** READ AHEAD WORKER **/
+
+ReadAheadWorker::ReadAheadWorker (
+    Iterator* iterator
+  , uint32_t limit
+  , uint32_t highWaterMarkBytes
+) : AsyncWorker(NULL, NULL)
+  , iterator(iterator)
+  , limit(limit)
+  , highWaterMarkBytes(highWaterMarkBytes)
+  , done(false)
+{};
+
+ReadAheadWorker::~ReadAheadWorker () {}
+
+void ReadAheadWorker::Execute () {
+  size_t bytes = 0;
+  keys.reserve(limit);
+  values.reserve(limit);
+  while (keys.size() < limit && bytes < highWaterMarkBytes) {
+    keys.push_back(std::string());
+    values.push_back(std::string());
+    if (!iterator->IteratorNext(keys.back(), values.back())) {
+      keys.pop_back();
+      values.pop_back();
+      iteratorStatus = iterator->IteratorStatus();
+      done = true;
+      break;
+    }
+    bytes += keys.back().size() + values.back().size();
+  }
+}
+
+void ReadAheadWorker::WorkComplete () {
+  NanScope();
+
+  // no callback of our own, the iterator hands entries out as asked
+  iterator->ReadAheadComplete(keys, values, done, iteratorStatus);
+}
+
 /** END WORKER **/
 
 EndWorker::EndWorker (
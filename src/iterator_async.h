@@ -6,6 +6,7 @@
 #ifndef LD_ITERATOR_ASYNC_H
 #define LD_ITERATOR_ASYNC_H
 
+#include <vector>
 #include <node.h>
 
 #include "nan.h"
@@ -34,6 +35,52 @@ private:
   bool ok;
 };
 
+class NextBatchWorker : public AsyncWorker {
+public:
+  NextBatchWorker (
+      Iterator* iterator
+    , NanCallback *callback
+    , void (*localCallback)(Iterator*)
+    , uint32_t limit
+    , uint32_t highWaterMarkBytes
+  );
+
+  virtual ~NextBatchWorker ();
+  virtual void Execute ();
+  virtual void HandleOKCallback ();
+  virtual void HandleErrorCallback ();
+
+private:
+  Iterator* iterator;
+  void (*localCallback)(Iterator*);
+  uint32_t limit;
+  uint32_t highWaterMarkBytes;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+};
+
+class ReadAheadWorker : public AsyncWorker {
+public:
+  ReadAheadWorker (
+      Iterator* iterator
+    , uint32_t limit
+    , uint32_t highWaterMarkBytes
+  );
+
+  virtual ~ReadAheadWorker ();
+  virtual void Execute ();
+  virtual void WorkComplete ();
+
+private:
+  Iterator* iterator;
+  uint32_t limit;
+  uint32_t highWaterMarkBytes;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  bool done;
+  leveldb::Status iteratorStatus;
+};
+
 class EndWorker : public AsyncWorker {
 public:
   EndWorker (
@@ -0,0 +1,121 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#include <node.h>
+
+#include "nan.h"
+#include "database.h"
+#include "snapshot.h"
+
+namespace leveldown {
+
+static v8::Persistent<v8::FunctionTemplate> snapshot_constructor;
+
+Snapshot::Snapshot (Database* database) : database(database) {
+  snapshot = database->NewSnapshot();
+  pinned   = 0;
+  released = false;
+};
+
+Snapshot::~Snapshot () {
+  if (snapshot != NULL)
+    Dispose();
+  if (!persistentHandle.IsEmpty())
+    NanDispose(persistentHandle);
+};
+
+void Snapshot::Dispose () {
+  database->ReleaseSnapshot(snapshot);
+  database->ForgetSnapshot(this);
+  snapshot = NULL;
+}
+
+void Snapshot::Pin () {
+  pinned++;
+  // a pinned snapshot must not be garbage collected
+  Ref();
+}
+
+void Snapshot::Unpin () {
+  pinned--;
+  if (released && pinned == 0 && snapshot != NULL)
+    Dispose();
+  Unref();
+}
+
+void Snapshot::ReleaseSnapshot () {
+  released = true;
+  if (pinned == 0 && snapshot != NULL)
+    Dispose();
+}
+
+bool Snapshot::IsReleased () const {
+  return released;
+}
+
+const leveldb::Snapshot* Snapshot::DbSnapshot () const {
+  return snapshot;
+}
+
+void Snapshot::Init () {
+  v8::Local<v8::FunctionTemplate> tpl =
+      v8::FunctionTemplate::New(Snapshot::New);
+  NanAssignPersistent(v8::FunctionTemplate, snapshot_constructor, tpl);
+  tpl->SetClassName(NanSymbol("Snapshot"));
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  NODE_SET_PROTOTYPE_METHOD(tpl, "release", Snapshot::Release);
+}
+
+NAN_METHOD(Snapshot::New) {
+  NanScope();
+
+  Database* database = node::ObjectWrap::Unwrap<Database>(args[0]->ToObject());
+
+  Snapshot* snapshot = new Snapshot(database);
+  snapshot->Wrap(args.This());
+
+  // the database must outlive its snapshots
+  v8::Local<v8::Object> obj = v8::Object::New();
+  obj->Set(NanSymbol("database"), args[0]);
+  NanAssignPersistent(v8::Object, snapshot->persistentHandle, obj);
+
+  NanReturnValue(args.This());
+}
+
+v8::Local<v8::Object> Snapshot::NewInstance (v8::Local<v8::Object> database) {
+  NanScope();
+
+  v8::Local<v8::FunctionTemplate> constructorHandle =
+      NanPersistentToLocal(snapshot_constructor);
+
+  v8::Handle<v8::Value> argv[1] = { database };
+  v8::Local<v8::Object> instance =
+      constructorHandle->GetFunction()->NewInstance(1, argv);
+
+  return scope.Close(instance);
+}
+
+Snapshot* Snapshot::FromOptions (v8::Local<v8::Object> optionsObj) {
+  if (optionsObj.IsEmpty() || !optionsObj->Has(NanSymbol("snapshot")))
+    return NULL;
+
+  v8::Local<v8::Value> value = optionsObj->Get(NanSymbol("snapshot"));
+  if (!value->IsObject()
+      || !NanPersistentToLocal(snapshot_constructor)->HasInstance(value))
+    return NULL;
+
+  return node::ObjectWrap::Unwrap<Snapshot>(value.As<v8::Object>());
+}
+
+NAN_METHOD(Snapshot::Release) {
+  NanScope();
+
+  Snapshot* snapshot = node::ObjectWrap::Unwrap<Snapshot>(args.This());
+  snapshot->ReleaseSnapshot();
+
+  NanReturnUndefined();
+}
+
+} // namespace leveldown
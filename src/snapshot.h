@@ -0,0 +1,70 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#ifndef LD_SNAPSHOT_H
+#define LD_SNAPSHOT_H
+
+#include <node.h>
+
+#include "nan.h"
+#include "database.h"
+
+/* LD_SNAPSHOT_FROM_OPTIONS sets up `leveldown::Snapshot* to` from the
+ * `snapshot` option, NULL if there isn't one. Needs `database` and
+ * `callback` in scope and will throw/return if the snapshot can't be used.
+ * A snapshot covers the database and all of its namespaces.
+ */
+#define LD_SNAPSHOT_FROM_OPTIONS(to, optionsObj)                              \
+  leveldown::Snapshot* to = leveldown::Snapshot::FromOptions(optionsObj);      \
+  if (to != NULL && to->IsReleased()) {                                        \
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "snapshot has been released")        \
+  }                                                                            \
+  if (to != NULL && to->database->root != database->root) {                    \
+    LD_RETURN_CALLBACK_OR_ERROR(callback, "snapshot is from another database") \
+  }
+
+namespace leveldown {
+
+class Database;
+
+/* A consistent, read-only view of the database as it was when the
+ * snapshot was taken. Reads and iterators in flight pin the snapshot so
+ * release() can be called at any time, the underlying transaction ends
+ * once the last of them is done with it.
+ */
+class Snapshot : public node::ObjectWrap {
+public:
+  static void Init ();
+  static v8::Local<v8::Object> NewInstance (v8::Local<v8::Object> database);
+  // the Snapshot in optionsObj's `snapshot` property, or NULL
+  static Snapshot* FromOptions (v8::Local<v8::Object> optionsObj);
+
+  Snapshot (Database* database);
+  ~Snapshot ();
+
+  // main thread only
+  void Pin ();
+  void Unpin ();
+  void ReleaseSnapshot ();
+  bool IsReleased () const;
+  const leveldb::Snapshot* DbSnapshot () const;
+
+  Database* database;
+
+private:
+  const leveldb::Snapshot* snapshot;
+  uint32_t pinned;
+  bool released;
+  v8::Persistent<v8::Object> persistentHandle;
+
+  void Dispose ();
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Release);
+};
+
+} // namespace leveldown
+
+#endif
@@ -9,6 +9,8 @@
 #include "database.h"
 #include "iterator.h"
 #include "batch.h"
+#include "snapshot.h"
+#include "bulk_loader.h"
 #include "wiredtigerdown_async.h"
 
 namespace leveldown {
@@ -77,6 +79,8 @@ void Init (v8::Handle<v8::Object> target) {
   Database::Init();
   leveldown::Iterator::Init();
   leveldown::Batch::Init();
+  leveldown::Snapshot::Init();
+  leveldown::BulkLoader::Init();
 
   v8::Local<v8::Function> leveldown =
       v8::FunctionTemplate::New(LevelDOWN)->GetFunction();
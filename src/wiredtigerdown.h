@@ -10,6 +10,7 @@
 #include <leveldb/slice.h>
 
 #include "nan.h"
+#include "arena.h"
 
 static inline size_t StringOrBufferLength(v8::Local<v8::Value> obj) {
   return node::Buffer::HasInstance(obj->ToObject())
@@ -17,54 +18,44 @@ static inline size_t StringOrBufferLength(v8::Local<v8::Value> obj) {
     : obj->ToString()->Utf8Length();
 }
 
-// NOTE: this MUST be called on objects created by
-// LD_STRING_OR_BUFFER_TO_SLICE
-static inline void DisposeStringOrBufferFromSlice(
-        v8::Persistent<v8::Object> &handle
-      , leveldb::Slice slice) {
-
-  if (!node::Buffer::HasInstance(NanPersistentToLocal(handle)->Get(NanSymbol("obj"))))
-    delete[] slice.data();
-  NanDispose(handle);
-}
-
-static inline void DisposeStringOrBufferFromSlice(
-        v8::Local<v8::Value> handle
-      , leveldb::Slice slice) {
-
-  if (!node::Buffer::HasInstance(handle))
-    delete[] slice.data();
-}
-
 #define LD_CB_ERR_IF_NULL_OR_UNDEFINED(thing, name)                            \
   if (thing->IsNull() || thing->IsUndefined()) {                               \
     LD_RETURN_CALLBACK_OR_ERROR(callback, #name " cannot be `null` or `undefined`") \
   }
 
-// NOTE: must call DisposeStringOrBufferFromSlice() on objects created here
-#define LD_STRING_OR_BUFFER_TO_SLICE(to, from, name)                           \
-  size_t to ## Sz_;                                                            \
-  char* to ## Ch_;                                                             \
-  if (node::Buffer::HasInstance(from->ToObject())) {                           \
-    to ## Sz_ = node::Buffer::Length(from->ToObject());                        \
-    if (to ## Sz_ == 0) {                                                      \
+// NOTE: String data is copied into `arena`, a leveldown::Arena, and the
+// Slice is valid for as long as the arena is. Buffer data is used in place
+// so the Buffer must be kept alive as well.
+static inline leveldb::Slice StringOrBufferToSlice(
+      v8::Local<v8::Value> from
+    , leveldown::Arena& arena) {
+  if (node::Buffer::HasInstance(from->ToObject())) {
+    return leveldb::Slice(
+        node::Buffer::Data(from->ToObject())
+      , node::Buffer::Length(from->ToObject())
+    );
+  }
+  v8::Local<v8::String> str = from->ToString();
+  size_t size = str->Utf8Length();
+  char* data = arena.Allocate(size);
+  str->WriteUtf8(data, -1, NULL, v8::String::NO_NULL_TERMINATION);
+  return leveldb::Slice(data, size);
+}
+
+// a Slice can't have length 0, a String is empty in UTF-8 only if it has no
+// characters at all so there's no need to measure it here
+#define LD_CB_ERR_IF_EMPTY(thing, name)                                        \
+  if (node::Buffer::HasInstance(thing->ToObject())) {                          \
+    if (node::Buffer::Length(thing->ToObject()) == 0) {                        \
       LD_RETURN_CALLBACK_OR_ERROR(callback, #name " cannot be an empty Buffer") \
     }                                                                          \
-    to ## Ch_ = node::Buffer::Data(from->ToObject());                          \
-  } else {                                                                     \
-    v8::Local<v8::String> to ## Str = from->ToString();                        \
-    to ## Sz_ = to ## Str->Utf8Length();                                       \
-    if (to ## Sz_ == 0) {                                                      \
-      LD_RETURN_CALLBACK_OR_ERROR(callback, #name " cannot be an empty String") \
-    }                                                                          \
-    to ## Ch_ = new char[to ## Sz_];                                           \
-    to ## Str->WriteUtf8(                                                      \
-        to ## Ch_                                                              \
-      , -1                                                                     \
-      , NULL, v8::String::NO_NULL_TERMINATION                                  \
-    );                                                                         \
-  }                                                                            \
-  leveldb::Slice to(to ## Ch_, to ## Sz_);
+  } else if (thing->ToString()->Length() == 0) {                               \
+    LD_RETURN_CALLBACK_OR_ERROR(callback, #name " cannot be an empty String")  \
+  }
+
+#define LD_STRING_OR_BUFFER_TO_SLICE(to, from, name, arena)                    \
+  LD_CB_ERR_IF_EMPTY(from, name)                                               \
+  leveldb::Slice to = StringOrBufferToSlice(from, arena);
 
 #define LD_RETURN_CALLBACK_OR_ERROR(callback, msg)                             \
   if (!callback.IsEmpty() && callback->IsFunction()) {                         \
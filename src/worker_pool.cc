@@ -0,0 +1,145 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#include <node.h>
+
+#include "worker_pool.h"
+
+namespace leveldown {
+
+WorkerPool::WorkerPool (uint32_t size)
+  : threads(size)
+  , active(0)
+  , running(size)
+  , stopping(false)
+  , stopped(NULL)
+  , stoppedArg(NULL)
+{
+  uv_mutex_init(&mutex);
+  uv_cond_init(&cond);
+  uv_async_init(uv_default_loop(), &async, WorkerPool::Complete);
+  async.data = this;
+  // an idle pool shouldn't keep the process alive
+  uv_unref((uv_handle_t*)&async);
+
+  for (uint32_t i = 0; i < size; i++)
+    uv_thread_create(&threads[i], WorkerPool::Run, this);
+}
+
+WorkerPool::~WorkerPool () {
+  uv_cond_destroy(&cond);
+  uv_mutex_destroy(&mutex);
+}
+
+uint32_t WorkerPool::Size () const {
+  return threads.size();
+}
+
+void WorkerPool::Stats (uint32_t* queued, uint32_t* active) {
+  uv_mutex_lock(&mutex);
+  *queued = pending.size();
+  *active = this->active;
+  uv_mutex_unlock(&mutex);
+}
+
+void WorkerPool::QueueWorker (NanAsyncWorker* worker) {
+  // keep the loop alive while there is work in flight
+  uv_ref((uv_handle_t*)&async);
+
+  uv_mutex_lock(&mutex);
+  pending.push_back(worker);
+  uv_cond_signal(&cond);
+  uv_mutex_unlock(&mutex);
+}
+
+void WorkerPool::Shutdown (void (*stopped)(void*), void* arg) {
+  this->stopped = stopped;
+  stoppedArg = arg;
+  // the last thread to stop wakes Complete(), which closes the pool
+  uv_ref((uv_handle_t*)&async);
+
+  uv_mutex_lock(&mutex);
+  stopping = true;
+  uv_cond_broadcast(&cond);
+  uv_mutex_unlock(&mutex);
+}
+
+/* Calls from worker threads, NO V8 HERE *****************************/
+
+void WorkerPool::Run (void* arg) {
+  WorkerPool* pool = static_cast<WorkerPool*>(arg);
+
+  for (;;) {
+    uv_mutex_lock(&pool->mutex);
+    while (pool->pending.empty() && !pool->stopping)
+      uv_cond_wait(&pool->cond, &pool->mutex);
+    if (pool->pending.empty()) {
+      // stopping, and the queue has been drained
+      pool->running--;
+      uv_mutex_unlock(&pool->mutex);
+      uv_async_send(&pool->async);
+      return;
+    }
+    NanAsyncWorker* worker = pool->pending.front();
+    pool->pending.pop_front();
+    pool->active++;
+    uv_mutex_unlock(&pool->mutex);
+
+    worker->Execute();
+
+    uv_mutex_lock(&pool->mutex);
+    pool->active--;
+    pool->completed.push_back(worker);
+    uv_mutex_unlock(&pool->mutex);
+    uv_async_send(&pool->async);
+  }
+}
+
+/* Main thread *****************************/
+
+void WorkerPool::Complete (uv_async_t* handle, int status) {
+  NanScope();
+
+  WorkerPool* pool = static_cast<WorkerPool*>(handle->data);
+  std::deque<NanAsyncWorker*> batch;
+
+  // a completing worker may call Shutdown(), keep going until nothing is
+  // left so we never close with callbacks outstanding
+  for (;;) {
+    uv_mutex_lock(&pool->mutex);
+    batch.swap(pool->completed);
+    bool idle = pool->pending.empty() && pool->active == 0;
+    bool finished = pool->stopping && pool->running == 0;
+    uv_mutex_unlock(&pool->mutex);
+
+    if (batch.empty()) {
+      if (finished) {
+        // every thread is on its way out, joining won't block
+        for (size_t i = 0; i < pool->threads.size(); i++)
+          uv_thread_join(&pool->threads[i]);
+        uv_close((uv_handle_t*)handle, WorkerPool::Closed);
+      } else if (idle && !pool->stopping) {
+        uv_unref((uv_handle_t*)handle);
+      }
+      return;
+    }
+
+    while (!batch.empty()) {
+      NanAsyncWorker* worker = batch.front();
+      batch.pop_front();
+      worker->WorkComplete();
+      delete worker;
+    }
+  }
+}
+
+void WorkerPool::Closed (uv_handle_t* handle) {
+  WorkerPool* pool = static_cast<WorkerPool*>(handle->data);
+  if (pool->stopped != NULL)
+    pool->stopped(pool->stoppedArg);
+  delete pool;
+}
+
+} // namespace leveldown
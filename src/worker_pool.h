@@ -0,0 +1,60 @@
+/* Copyright (c) 2012-2013 LevelDOWN contributors
+ * See list at <https://github.com/rvagg/node-leveldown#contributing>
+ * MIT +no-false-attribs License <https://github.com/rvagg/node-leveldown/blob/master/LICENSE>
+ */
+
+#ifndef LD_WORKER_POOL_H
+#define LD_WORKER_POOL_H
+
+#include <deque>
+#include <vector>
+#include <node.h>
+
+#include "nan.h"
+
+namespace leveldown {
+
+/* A fixed set of threads with its own queue that runs NanAsyncWorkers the
+ * same way NanAsyncQueueWorker() does on the libuv thread pool: Execute()
+ * on one of our threads, then WorkComplete() and delete in the main thread.
+ */
+class WorkerPool {
+public:
+  WorkerPool (uint32_t size);
+
+  void QueueWorker (NanAsyncWorker* worker);
+  // main thread only, lets the threads stop once all queued work has been
+  // executed without waiting for them; stopped(arg) is called in the main
+  // thread after the last worker completes, then the pool deletes itself
+  void Shutdown (void (*stopped)(void*), void* arg);
+
+  uint32_t Size () const;
+  void Stats (uint32_t* queued, uint32_t* active);
+
+private:
+  ~WorkerPool ();
+
+  static void Run (void* arg);
+  static void Complete (uv_async_t* handle, int status);
+  static void Closed (uv_handle_t* handle);
+
+  std::vector<uv_thread_t> threads;
+  std::deque<NanAsyncWorker*> pending;
+  std::deque<NanAsyncWorker*> completed;
+  uv_mutex_t mutex;
+  uv_cond_t cond;
+  uv_async_t async;
+  uint32_t active;
+  uint32_t running;
+  bool stopping;
+  void (*stopped)(void*);
+  void* stoppedArg;
+
+  // No copying allowed
+  WorkerPool (const WorkerPool&);
+  void operator= (const WorkerPool&);
+};
+
+} // namespace leveldown
+
+#endif
@@ -2,6 +2,143 @@ const test       = require('tap').test
     , testCommon = require('abstract-leveldown/testCommon')
     , leveldown  = require('../')
     , abstract   = require('abstract-leveldown/abstract/approximate-size-test')
+    , crypto     = require('crypto')
 
-if (require.main === module)
-  abstract.all(leveldown, test, testCommon)
\ No newline at end of file
+if (require.main === module) {
+  abstract.all(leveldown, test, testCommon)
+  estimateTests()
+}
+
+// approximateSize() goes by the sizes of the data files and a sample of
+// the keys in each LSM chunk, so these write enough entries, in small
+// chunks, to be spread over several files
+function estimateTests () {
+  var db
+
+  function key (i) {
+    return 'k' + String(100000 + i).slice(1)
+  }
+
+  function write (from, to, callback) {
+    if (from >= to)
+      return callback()
+    var ops = []
+    for (var i = from; i < to && ops.length < 1000; i++)
+      ops.push({ type: 'put', key: key(i), value: crypto.randomBytes(200) })
+    db.batch(ops, function (err) {
+      if (err)
+        return callback(err)
+      write(i, to, callback)
+    })
+  }
+
+  // sizes of the ranges between consecutive `bounds`, and of the whole
+  function sizes (bounds, callback) {
+    var result = []
+    function next (i) {
+      var start = i < bounds.length - 1 ? bounds[i] : bounds[0]
+        , end   = i < bounds.length - 1 ? bounds[i + 1] : bounds[bounds.length - 1]
+      db.approximateSize(start, end, function (err, size) {
+        if (err)
+          return callback(err)
+        result.push(size)
+        if (i == bounds.length - 1)
+          return callback(null, result.slice(0, -1), size)
+        next(i + 1)
+      })
+    }
+    next(0)
+  }
+
+  function checkParts (t, parts, whole) {
+    var sum = parts.reduce(function (a, b) { return a + b }, 0)
+    parts.forEach(function (size, i) {
+      t.ok(size > 0, 'part ' + i + ' has a size')
+    })
+    t.ok(sum >= whole * 0.75 && sum <= whole * 1.25
+      , 'parts (' + sum + ') add up to about the whole (' + whole + ')')
+  }
+
+  var bounds = [ key(0), key(5000), key(10000), key(15000), key(20000) ]
+    , firstSize
+    , secondSize
+
+  test('setUp common', testCommon.setUp)
+
+  test('setUp db', function (t) {
+    db = leveldown(testCommon.location())
+    db.open({ writeBufferSize: 512 * 1024, compression: false }, t.end.bind(t))
+  })
+
+  test('test approximateSize() grows with the data written', function (t) {
+    write(0, 10000, function (err) {
+      t.notOk(err, 'no error from batch()')
+      db.compactRange(null, null, function (err) {
+        t.notOk(err, 'no error from compactRange()')
+        db.approximateSize(key(0), key(20000), function (err, size) {
+          t.notOk(err, 'no error')
+          t.ok(size >= 10000 * 200 * 0.5, 'first half has a size (' + size + ')')
+          firstSize = size
+          write(10000, 20000, function (err) {
+            t.notOk(err, 'no error from batch()')
+            db.compactRange(null, null, function (err) {
+              t.notOk(err, 'no error from compactRange()')
+              db.approximateSize(key(0), key(20000), function (err, size) {
+                t.notOk(err, 'no error')
+                t.ok(size > firstSize * 1.5
+                  , 'size grew (' + firstSize + ' to ' + size + ')')
+                secondSize = size
+                t.end()
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+
+  test('test approximateSize() of disjoint ranges adds up', function (t) {
+    sizes(bounds, function (err, parts, whole) {
+      t.notOk(err, 'no error')
+      checkParts(t, parts, whole)
+      t.end()
+    })
+  })
+
+  test('test approximateSize() outside all keys', function (t) {
+    db.approximateSize('a', 'b', function (err, size) {
+      t.notOk(err, 'no error')
+      t.equal(size, 0, 'nothing before the keys')
+      db.approximateSize('x', 'z', function (err, size) {
+        t.notOk(err, 'no error')
+        t.equal(size, 0, 'nothing after the keys')
+        t.end()
+      })
+    })
+  })
+
+  test('test approximateSize() after compactRange() merges chunks', function (t) {
+    // overwrite the second half, so there are chunks to merge
+    write(10000, 20000, function (err) {
+      t.notOk(err, 'no error from batch()')
+      db.compactRange(null, null, function (err) {
+        t.notOk(err, 'no error from compactRange()')
+        sizes(bounds, function (err, parts, whole) {
+          t.notOk(err, 'no error')
+          t.ok(whole >= secondSize * 0.5 && whole <= secondSize * 2
+            , 'whole is about what it was (' + secondSize + ' to ' + whole + ')')
+          checkParts(t, parts, whole)
+          db.approximateSize('x', 'z', function (err, size) {
+            t.notOk(err, 'no error')
+            t.equal(size, 0, 'still nothing after the keys')
+            t.end()
+          })
+        })
+      })
+    })
+  })
+
+  test('tearDown', function (t) {
+    db.close(testCommon.tearDown.bind(null, t))
+  })
+}
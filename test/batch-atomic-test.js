@@ -0,0 +1,49 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open({ writeThreads: 4 }, t.end.bind(t))
+})
+
+test('test concurrent batch() writes to the same keys', function (t) {
+  var pending = 40
+  for (var r = 0; r < 40; r++) {
+    var ops = []
+    for (var i = 0; i < 50; i++)
+      ops.push({ type: 'put', key: 'k' + i, value: 'r' + r })
+    db.batch(ops, function (err) {
+      t.notOk(err, 'no error from batch()')
+      if (--pending == 0)
+        t.end()
+    })
+  }
+})
+
+test('test every key was written by the same batch()', function (t) {
+  var iterator = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+    , values = {}
+  function next () {
+    iterator.next(function (err, key, value) {
+      t.notOk(err, 'no error from next()')
+      if (key === undefined) {
+        return iterator.end(function () {
+          t.equal(Object.keys(values).length, 1, 'one value for all keys')
+          t.end()
+        })
+      }
+      values[value] = true
+      next()
+    })
+  }
+  next()
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
@@ -0,0 +1,77 @@
+const test        = require('tap').test
+    , testCommon  = require('abstract-leveldown/testCommon')
+    , leveldown   = require('../')
+    , encodeBatch = leveldown.encodeBatch
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(t.end.bind(t))
+})
+
+test('test encodeBatch() layout', function (t) {
+  var buf = encodeBatch([
+      { type: 'put', key: 'a', value: '1' }
+    , { type: 'del', key: new Buffer('bb') }
+  ])
+  t.equal(buf.toString('hex'), '000000000000000002000000' + '0101610131' + '00026262', 'WriteBatch layout')
+  t.throws(encodeBatch.bind(null, [ { type: 'put', key: 'a' } ]), 'put requires a value')
+  t.throws(encodeBatch.bind(null, [ { type: 'del', key: '' } ]), 'empty key')
+  t.end()
+})
+
+test('test batchBuffer() argument errors', function (t) {
+  t.throws(db.batchBuffer.bind(db, new Buffer(12)), 'requires a callback')
+  db.batchBuffer('foo', function (err) {
+    t.ok(err, 'error for a non-Buffer')
+    db.batchBuffer(new Buffer(4), function (err) {
+      t.ok(err, 'error for a short Buffer')
+      t.end()
+    })
+  })
+})
+
+test('test batchBuffer() puts and dels', function (t) {
+  var ops = []
+  for (var i = 0; i < 1000; i++)
+    ops.push({ type: 'put', key: 'key' + i, value: 'value' + i })
+  ops.push({ type: 'del', key: 'key500' })
+  db.batchBuffer(encodeBatch(ops), { sync: true }, function (err) {
+    t.notOk(err, 'no error from batchBuffer()')
+    db.get('key999', { asBuffer: false }, function (err, value) {
+      t.notOk(err, 'no error from get()')
+      t.equal(value, 'value999', 'correct value')
+      db.get('key500', function (err) {
+        t.ok(err, 'entry has been deleted')
+        t.end()
+      })
+    })
+  })
+})
+
+test('test batchBuffer() with a bad count writes nothing', function (t) {
+  var buf = encodeBatch([ { type: 'put', key: 'bad', value: 'count' } ])
+  buf.writeUInt32LE(2, 8)
+  db.batchBuffer(buf, function (err) {
+    t.ok(err, 'error from batchBuffer()')
+    t.ok(/Corruption/.test(err.message), 'Corruption error')
+    db.get('bad', function (err) {
+      t.ok(err, 'entry was not written')
+      t.end()
+    })
+  })
+})
+
+test('test batchBuffer() with an empty batch', function (t) {
+  db.batchBuffer(encodeBatch([]), function (err) {
+    t.notOk(err, 'no error from batchBuffer()')
+    t.end()
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
@@ -0,0 +1,217 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+    , Readable   = require('stream').Readable
+
+function pad (i) {
+  return ('0000000' + i).slice(-8)
+}
+
+function entries (n) {
+  var list = []
+  for (var i = 0; i < n; i++)
+    list.push({ key: 'key' + pad(i), value: 'value' + i })
+  return list
+}
+
+function putBuffer (n) {
+  return leveldown.encodeBatch(entries(n).map(function (entry) {
+    return { type: 'put', key: entry.key, value: entry.value }
+  }))
+}
+
+function openDb (t, callback) {
+  var db = leveldown(testCommon.location())
+  db.open(function (err) {
+    t.notOk(err, 'no error')
+    callback(db)
+  })
+}
+
+function checkAll (t, db, n, callback) {
+  var iterator = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+    , count    = 0
+  function next () {
+    iterator.next(function (err, key, value) {
+      t.notOk(err, 'no error')
+      if (key === undefined && value === undefined)
+        return iterator.end(function () {
+          t.equal(count, n, 'every entry loaded')
+          callback()
+        })
+      if (key != 'key' + pad(count) || value != 'value' + count)
+        t.fail('entry ' + count + ' is ' + key + '=' + value)
+      count++
+      next()
+    })
+  }
+  next()
+}
+
+test('setUp common', testCommon.setUp)
+
+test('test bulkLoad() from an Array', function (t) {
+  openDb(t, function (db) {
+    db.bulkLoad(entries(20000), { bufferSize: 64 * 1024 }, function (err) {
+      t.notOk(err, 'no error')
+      checkAll(t, db, 20000, function () {
+        db.close(t.end.bind(t))
+      })
+    })
+  })
+})
+
+test('test bulkLoad() from an iterator', function (t) {
+  openDb(t, function (db) {
+    var list = entries(5000)
+    db.batch(list.map(function (e) {
+      return { type: 'put', key: e.key, value: e.value }
+    }), function (err) {
+      t.notOk(err, 'no error')
+      openDb(t, function (db2) {
+        db2.bulkLoad(db.iterator(), function (err) {
+          t.notOk(err, 'no error')
+          checkAll(t, db2, 5000, function () {
+            db2.close(function () {
+              db.close(t.end.bind(t))
+            })
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test bulkLoad() from a stream', function (t) {
+  openDb(t, function (db) {
+    var list   = entries(5000)
+      , stream = new Readable({ objectMode: true })
+    stream._read = function () {
+      stream.push(list.length ? list.shift() : null)
+    }
+    db.bulkLoad(stream, function (err) {
+      t.notOk(err, 'no error')
+      checkAll(t, db, 5000, function () {
+        db.close(t.end.bind(t))
+      })
+    })
+  })
+})
+
+test('test bulk-loaded entries have a Bloom filter', function (t) {
+  openDb(t, function (db) {
+    db.bulkLoad(entries(20000), function (err) {
+      t.notOk(err, 'no error')
+      var misses = Number(db.getProperty('wiredtiger.bloom.misses'))
+        , pending = 100
+      for (var i = 0; i < 100; i++) {
+        db.get('key' + pad(i * 100) + 'x', function (err) {
+          t.ok(err && /NotFound/.test(err.message), 'missing key not found')
+          if (--pending > 0)
+            return
+          t.ok(Number(db.getProperty('wiredtiger.bloom.misses')) - misses >= 90
+            , 'the Bloom filter answers for missing keys')
+          db.close(t.end.bind(t))
+        })
+      }
+    })
+  })
+})
+
+test('test writes during bulkLoad() take precedence', function (t) {
+  openDb(t, function (db) {
+    var loader = db.bulkLoader()
+    loader.write(leveldown.encodeBatch([
+        { type: 'put', key: 'a', value: 'loaded' }
+      , { type: 'put', key: 'b', value: 'loaded' }
+    ]), function (err) {
+      t.notOk(err, 'no error')
+      db.put('a', 'newer', function (err) {
+        t.notOk(err, 'no error')
+        loader.finish(function (err) {
+          t.notOk(err, 'no error')
+          db.get('a', { asBuffer: false }, function (err, value) {
+            t.equal(value, 'newer', 'later put wins')
+            db.get('b', { asBuffer: false }, function (err, value) {
+              t.equal(value, 'loaded', 'loaded entry')
+              db.close(t.end.bind(t))
+            })
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test bulkLoad() errors', function (t) {
+  openDb(t, function (db) {
+    var loader = db.bulkLoader()
+    t.throws(db.bulkLoader.bind(db), 'one load at a time')
+    loader.write(leveldown.encodeBatch([ { type: 'del', key: 'a' } ]), function (err) {
+      t.ok(err, 'bulk load batches only hold puts')
+      db.bulkLoad([], function (err) {
+        t.ok(err, 'error while another load runs')
+        loader.finish(function (err) {
+          t.notOk(err, 'no error')
+          loader.finish(function (err) {
+            t.ok(err, 'already finished')
+            db.bulkLoad([ { key: 'b', value: '1' }, { key: 'a', value: '1' } ], function (err) {
+              t.ok(err, 'keys out of order')
+              db.get('b', function (err) {
+                t.ok(err && /NotFound/.test(err.message), 'nothing loaded')
+                db.put('c', '1', function (err) {
+                  t.notOk(err, 'no error')
+                  db.bulkLoad(entries(10), function (err) {
+                    t.ok(err, 'database is not empty')
+                    db.close(t.end.bind(t))
+                  })
+                })
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test overlapping bulk loader calls', function (t) {
+  openDb(t, function (db) {
+    var loader = db.bulkLoader()
+    loader.write(putBuffer(1000), function (err) {
+      t.notOk(err, 'no error')
+      loader.finish(function (err) {
+        t.notOk(err, 'no error')
+        checkAll(t, db, 1000, function () {
+          db.close(t.end.bind(t))
+        })
+      })
+    })
+    loader.write(leveldown.encodeBatch([ { type: 'put', key: 'z', value: '1' } ]), function (err) {
+      t.ok(err && /previous write\(\)/.test(err.message), 'write() during write()')
+    })
+    loader.finish(function (err) {
+      t.ok(err && /previous write\(\)/.test(err.message), 'finish() during write()')
+    })
+  })
+})
+
+test('test close() during a bulk loader write()', function (t) {
+  openDb(t, function (db) {
+    var loader = db.bulkLoader()
+      , written = false
+    loader.write(putBuffer(1000), function (err) {
+      t.notOk(err, 'no error')
+      written = true
+    })
+    db.close(function (err) {
+      t.notOk(err, 'no error')
+      t.ok(written, 'write() completed before close()')
+      t.end()
+    })
+  })
+})
+
+test('tearDown', function (t) {
+  testCommon.tearDown(t)
+})
@@ -0,0 +1,101 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+    , rangeData  = require('./range-data')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(t.end.bind(t))
+})
+
+function fill (t) {
+  rangeData.fill(db, t.end.bind(t))
+}
+
+function clearTest (name, options, count, kept, gone) {
+  test('setUp data', fill)
+  test('test clear() ' + name, function (t) {
+    db.clear(options, function (err) {
+      t.notOk(err, 'no error from clear()')
+      rangeData.keys(db, function (err, result) {
+        t.notOk(err, 'no error from iterator')
+        t.equal(result.length, count, 'correct number of keys left')
+        t.ok(result.indexOf(kept) != -1, kept + ' is left')
+        t.equal(result.indexOf(gone), -1, gone + ' is gone')
+        t.end()
+      })
+    })
+  })
+}
+
+clearTest('with gte and lt', { gte: 'k10', lt: 'k90' }, 20, 'k90', 'k10')
+clearTest('with gt and lte', { gt: 'k10', lte: 'k90' }, 20, 'k10', 'k90')
+clearTest('with only gt', { gt: 'k49' }, 50, 'k49', 'k99')
+clearTest('with only lte', { lte: 'k49' }, 50, 'k50', 'k00')
+clearTest('prefers gt to gte', { gte: 'k10', gt: 'k10', lt: 'k20' }, 91, 'k10', 'k11')
+
+test('setUp data', fill)
+test('test clear() with bounds that are not keys', function (t) {
+  db.clear({ gt: 'k50a', lt: 'k60a' }, function (err) {
+    t.notOk(err, 'no error from clear()')
+    db.get('k50', function (err) {
+      t.notOk(err, 'k50 is left')
+      db.get('k51', function (err) {
+        t.ok(err, 'k51 is gone')
+        db.get('k60', function (err) {
+          t.ok(err, 'k60 is gone')
+          db.get('k61', function (err) {
+            t.notOk(err, 'k61 is left')
+            t.end()
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test clear() of an empty range', function (t) {
+  db.clear({ gt: 'z' }, function (err) {
+    t.notOk(err, 'no error from clear()')
+    db.clear({ gte: 'k40', lt: 'k30' }, function (err) {
+      t.notOk(err, 'no error from clear() with crossed bounds')
+      t.end()
+    })
+  })
+})
+
+test('test clear() of everything', function (t) {
+  db.clear(function (err) {
+    t.notOk(err, 'no error from clear()')
+    rangeData.keys(db, function (err, result) {
+      t.notOk(err, 'no error from iterator')
+      t.equal(result.length, 0, 'no keys left')
+      t.end()
+    })
+  })
+})
+
+test('test clear() of a range removed in several transactions', function (t) {
+  var ops = []
+  for (var i = 0; i < 25000; i++)
+    ops.push({ type: 'put', key: 'm' + (100000 + i), value: 'v' })
+  db.batch(ops, function (err) {
+    t.notOk(err, 'no error from batch()')
+    db.clear({ gt: 'm100000', lt: 'm124999' }, function (err) {
+      t.notOk(err, 'no error from clear()')
+      rangeData.keys(db, function (err, result) {
+        t.notOk(err, 'no error from iterator')
+        t.deepEqual(result, [ 'm100000', 'm124999' ], 'only the bounds are left')
+        t.end()
+      })
+    })
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
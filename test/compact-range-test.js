@@ -0,0 +1,71 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+    , rangeData  = require('./range-data')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(t.end.bind(t))
+})
+
+test('setUp data', function (t) {
+  rangeData.fill(db, t.end.bind(t))
+})
+
+test('test compactRange() throws without a callback', function (t) {
+  t.throws(db.compactRange.bind(db), { name: 'Error', message: 'compactRange() requires a callback argument' })
+  t.throws(db.compactRange.bind(db, 'k00', 'k99'), { name: 'Error', message: 'compactRange() requires a callback argument' })
+  t.end()
+})
+
+test('test compactRange() with an empty start', function (t) {
+  db.compactRange('', 'k99', function (err) {
+    t.ok(err, 'got an error')
+    t.equal(err.message, 'start cannot be an empty String')
+    t.end()
+  })
+})
+
+function checkStats (t, stats) {
+  t.equal(typeof stats, 'object', 'got stats')
+  t.ok(stats.chunksMerged >= 0, 'chunksMerged is a count')
+  t.ok(stats.bytesReclaimed >= 0, 'bytesReclaimed is a count')
+  t.ok(stats.filesCompacted >= 0, 'filesCompacted is a count')
+}
+
+test('test compactRange() outside the data', function (t) {
+  db.compactRange('x', 'z', function (err, stats) {
+    t.notOk(err, 'no error')
+    checkStats(t, stats)
+    t.equal(stats.filesCompacted, 0, 'nothing compacted')
+    t.end()
+  })
+})
+
+test('test compactRange() over a range', function (t) {
+  db.compactRange('k10', 'k20', function (err, stats) {
+    t.notOk(err, 'no error')
+    checkStats(t, stats)
+    db.get('k15', { asBuffer: false }, function (err, value) {
+      t.notOk(err, 'no error from get()')
+      t.equal(value, 'v15', 'data is intact')
+      t.end()
+    })
+  })
+})
+
+test('test compactRange() with open ends', function (t) {
+  db.compactRange(null, undefined, function (err, stats) {
+    t.notOk(err, 'no error')
+    checkStats(t, stats)
+    t.end()
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
@@ -0,0 +1,77 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+function syncs () {
+  return Number(db.getProperty('wiredtiger.log.syncs'))
+}
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(t.end.bind(t))
+})
+
+test('test writes without sync do not sync the log', function (t) {
+  var before = syncs()
+  db.put('a', 'a', function (err) {
+    t.notOk(err, 'no error from put()')
+    db.batch([ { type: 'put', key: 'b', value: 'b' } ], function (err) {
+      t.notOk(err, 'no error from batch()')
+      t.equal(syncs(), before, 'log was not synced')
+      t.end()
+    })
+  })
+})
+
+test('test writes with sync sync the log', function (t) {
+  var before = syncs()
+  db.put('c', 'c', { sync: true }, function (err) {
+    t.notOk(err, 'no error from put()')
+    t.ok(syncs() > before, 'put() synced the log')
+    before = syncs()
+    db.del('a', { sync: true }, function (err) {
+      t.notOk(err, 'no error from del()')
+      t.ok(syncs() > before, 'del() synced the log')
+      before = syncs()
+      db.batch([ { type: 'put', key: 'd', value: 'd' }, { type: 'del', key: 'b' } ], { sync: true }, function (err) {
+        t.notOk(err, 'no error from batch()')
+        t.equal(syncs(), before + 1, 'batch() synced the log once')
+        t.end()
+      })
+    })
+  })
+})
+
+test('test concurrent sync writes share log syncs', function (t) {
+  // a pool of write threads gets the writes to the log at the same time,
+  // so they can wait on one sync between them
+  var pooled = leveldown(testCommon.location())
+  pooled.open({ writeThreads: 8 }, function (err) {
+    t.notOk(err, 'no error from open()')
+    var before = Number(pooled.getProperty('wiredtiger.log.syncs'))
+      , pending = 200
+    for (var i = 0; i < 200; i++) {
+      pooled.put('k' + i, 'v' + i, { sync: true }, function (err) {
+        t.notOk(err, 'no error from put()')
+        if (--pending > 0)
+          return
+        var count = Number(pooled.getProperty('wiredtiger.log.syncs')) - before
+        t.ok(count > 0, 'the log was synced')
+        t.ok(count < 200, 'fewer syncs than writes (' + count + ')')
+        pooled.get('k199', { asBuffer: false }, function (err, value) {
+          t.notOk(err, 'no error from get()')
+          t.equal(value, 'v199', 'write is readable')
+          pooled.close(t.end.bind(t))
+        })
+      })
+    }
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
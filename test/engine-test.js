@@ -0,0 +1,74 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db, location
+
+test('setUp common', testCommon.setUp)
+
+test('test open() with an unknown engine', function (t) {
+  var bad = leveldown(testCommon.location())
+  bad.open({ engine: 'hash' }, function (err) {
+    t.ok(err, 'errors')
+    t.end()
+  })
+})
+
+test('setUp btree db', function (t) {
+  location = testCommon.location()
+  db = leveldown(location)
+  db.open({ engine: 'btree' }, t.end.bind(t))
+})
+
+test('test put() and get() on a btree', function (t) {
+  db.batch([
+      { type: 'put', key: 'b', value: '2' }
+    , { type: 'put', key: 'a', value: '1' }
+  ], function (err) {
+    t.notOk(err, 'no error')
+    db.get('a', { asBuffer: false }, function (err, value) {
+      t.notOk(err, 'no error')
+      t.equal(value, '1', 'read back')
+      db.get('c', function (err) {
+        t.ok(err && /NotFound/.test(err.message), 'missing key')
+        t.end()
+      })
+    })
+  })
+})
+
+test('test bulkLoader() refuses a btree', function (t) {
+  t.throws(db.bulkLoader.bind(db), 'btree tables can\'t be bulk loaded')
+  t.end()
+})
+
+test('test namespace() engines', function (t) {
+  t.throws(db.namespace.bind(db, 'bad', { engine: 'hash' }), 'unknown engine')
+  var lsm = db.namespace('lsm', { engine: 'lsm' })
+  lsm.bulkLoad([ { key: 'k', value: 'v' } ], function (err) {
+    t.notOk(err, 'an lsm namespace of a btree database bulk loads')
+    lsm.get('k', { asBuffer: false }, function (err, value) {
+      t.equal(value, 'v', 'loaded')
+      lsm.close(t.end.bind(t))
+    })
+  })
+})
+
+test('test the engine is kept on reopen', function (t) {
+  db.close(function (err) {
+    t.notOk(err, 'no error')
+    db = leveldown(location)
+    db.open({ engine: 'lsm' }, function (err) {
+      t.notOk(err, 'no error')
+      t.throws(db.bulkLoader.bind(db), 'still a btree')
+      db.get('b', { asBuffer: false }, function (err, value) {
+        t.equal(value, '2', 'entries kept')
+        db.close(t.end.bind(t))
+      })
+    })
+  })
+})
+
+test('tearDown', function (t) {
+  testCommon.tearDown(t)
+})
@@ -0,0 +1,49 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+    , makeTest   = require('./make-test')
+
+makeTest('test non-array getMany() errors', function (db, t, done) {
+  db.getMany('one', function (err) {
+    t.ok(err, 'got error')
+    t.equal(err.message, 'getMany() requires an array of keys', 'correct error message')
+    done()
+  })
+})
+
+makeTest('test getMany() with empty array', function (db, t, done) {
+  db.getMany([], function (err, values) {
+    t.notOk(err, 'no error from getMany()')
+    t.deepEqual(values, [], 'no values')
+    done()
+  })
+})
+
+makeTest('test getMany() returns values in caller order', function (db, t, done) {
+  db.getMany([ 'two', 'one', 'three' ], { asBuffer: false }, function (err, values) {
+    t.notOk(err, 'no error from getMany()')
+    t.deepEqual(values, [ '2', '1', '3' ], 'correct values')
+    done()
+  })
+})
+
+makeTest('test getMany() with missing keys', function (db, t, done) {
+  db.getMany([ 'one', 'nope', 'two' ], { asBuffer: false }, function (err, values) {
+    t.notOk(err, 'no error from getMany()')
+    t.equal(values.length, 3, 'one slot per key')
+    t.equal(values[0], '1', 'found key')
+    t.equal(values[1], undefined, 'missing key is undefined')
+    t.equal(values[2], '2', 'found key')
+    done()
+  })
+})
+
+makeTest('test getMany() with Buffer keys and values', function (db, t, done) {
+  db.getMany([ new Buffer('three'), 'one' ], function (err, values) {
+    t.notOk(err, 'no error from getMany()')
+    t.ok(Buffer.isBuffer(values[0]), 'value is a Buffer')
+    t.equal(values[0].toString(), '3', 'correct value')
+    t.equal(values[1].toString(), '1', 'correct value')
+    done()
+  })
+})
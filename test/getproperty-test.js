@@ -52,6 +52,34 @@ test('test invalid getProperty("leveldb.sstables")', function (t) {
   t.end()
 })
 
+test('test getProperty("wiredtiger.stats")', function (t) {
+  var stats = db.getProperty('wiredtiger.stats')
+  t.ok(stats.split('\n').length > 3, 'wiredtiger.stats has > 3 newlines')
+  t.ok(/^connection\n/.test(stats), 'starts with the connection statistics')
+  t.end()
+})
+
+test('test getProperty() of single statistics returns numbers', function (t) {
+  [ 'wiredtiger.cache.bytes'
+  , 'wiredtiger.cache.bytes-max'
+  , 'wiredtiger.log.bytes'
+  , 'wiredtiger.lsm.chunks'
+  , 'wiredtiger.bloom.hits'
+  ].forEach(function (property) {
+    t.ok(/^\d+$/.test(db.getProperty(property)), property + ' is a number')
+  })
+  t.end()
+})
+
+test('test getProperty() without statistics returns empty strings', function (t) {
+  var db = leveldown(testCommon.location())
+  db.open({ statistics: 'none' }, function (err) {
+    t.notOk(err, 'no error from open()')
+    t.equal(db.getProperty('wiredtiger.cache.bytes'), '', 'no statistics')
+    db.close(t.end.bind(t))
+  })
+})
+
 test('tearDown', function (t) {
   db.close(testCommon.tearDown.bind(null, t))
-})
\ No newline at end of file
+})
@@ -0,0 +1,80 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open({ groupCommit: true }, t.end.bind(t))
+})
+
+test('test put() calls in the same tick are all called back', function (t) {
+  var pending = 100
+  t.plan(pending * 2)
+  for (var i = 0; i < 100; i++) {
+    db.put('key' + i, 'value' + i, function (err) {
+      t.notOk(err, 'no error from put()')
+      if (--pending === 0) {
+        db.get('key42', { asBuffer: false }, function (err, value) {
+          t.notOk(err, 'no error from get()')
+          t.equal(value, 'value42', 'correct value')
+        })
+      }
+    })
+  }
+})
+
+test('test mixed put() and del() keep their order', function (t) {
+  db.put('foo', 'bar', function (err) {
+    t.notOk(err, 'no error from put()')
+  })
+  db.del('foo', function (err) {
+    t.notOk(err, 'no error from del()')
+    db.get('foo', function (err) {
+      t.ok(err, 'entry has been deleted')
+      t.ok(/NotFound/.test(err.message), 'NotFound error')
+      t.end()
+    })
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
+
+test('setUp db with a window', function (t) {
+  db = leveldown(testCommon.location())
+  db.open({ groupCommit: true, groupCommitWindow: 2000 }, t.end.bind(t))
+})
+
+test('test put() calls across ticks within the window', function (t) {
+  db.put('a', '1', function (err) {
+    t.notOk(err, 'no error from put()')
+  })
+  setImmediate(function () {
+    db.put('b', '2', function (err) {
+      t.notOk(err, 'no error from put()')
+      db.get('a', { asBuffer: false }, function (err, value) {
+        t.notOk(err, 'no error from get()')
+        t.equal(value, '1', 'correct value')
+        t.end()
+      })
+    })
+  })
+})
+
+test('test close() flushes pending writes', function (t) {
+  var written = false
+  db.put('c', '3', function (err) {
+    t.notOk(err, 'no error from put()')
+    written = true
+  })
+  db.close(function (err) {
+    t.notOk(err, 'no error from close()')
+    t.ok(written, 'put() was written before close() completed')
+    testCommon.tearDown(t)
+  })
+})
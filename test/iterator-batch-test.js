@@ -0,0 +1,75 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+    , makeTest   = require('./make-test')
+
+makeTest('test argument-less nextBatch() throws', function (db, t, done) {
+  var it = db.iterator()
+  t.throws(
+      it.nextBatch.bind(it)
+    , { name: 'Error', message: 'nextBatch() requires a callback argument' }
+    , 'no-arg nextBatch() throws'
+  )
+  it.end(done)
+})
+
+makeTest('test nextBatch() returns all entries', function (db, t, done) {
+  var it = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+  it.nextBatch(function (err, keys, values) {
+    t.notOk(err, 'no error from nextBatch()')
+    t.deepEqual(keys, [ 'one', 'three', 'two' ], 'correct keys')
+    t.deepEqual(values, [ '1', '3', '2' ], 'correct values')
+    it.nextBatch(function (err, keys, values) {
+      t.notOk(err, 'no error from nextBatch()')
+      t.equal(keys.length, 0, 'no more keys')
+      t.equal(values.length, 0, 'no more values')
+      it.end(done)
+    })
+  })
+})
+
+makeTest('test nextBatch() with limit', function (db, t, done) {
+  var it = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+  it.nextBatch({ limit: 2 }, function (err, keys, values) {
+    t.notOk(err, 'no error from nextBatch()')
+    t.deepEqual(keys, [ 'one', 'three' ], 'first batch of keys')
+    t.deepEqual(values, [ '1', '3' ], 'first batch of values')
+    it.nextBatch({ limit: 2 }, function (err, keys, values) {
+      t.notOk(err, 'no error from nextBatch()')
+      t.deepEqual(keys, [ 'two' ], 'second batch of keys')
+      t.deepEqual(values, [ '2' ], 'second batch of values')
+      it.end(done)
+    })
+  })
+})
+
+makeTest('test nextBatch() with highWaterMarkBytes', function (db, t, done) {
+  var it = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+  it.nextBatch({ highWaterMarkBytes: 1 }, function (err, keys, values) {
+    t.notOk(err, 'no error from nextBatch()')
+    t.deepEqual(keys, [ 'one' ], 'stops once highWaterMarkBytes is reached')
+    it.end(done)
+  })
+})
+
+makeTest('test nextBatch() mixed with next()', function (db, t, done) {
+  var it = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+  it.next(function (err, key, value) {
+    t.notOk(err, 'no error from next()')
+    t.equal(key, 'one', 'correct key')
+    it.nextBatch(function (err, keys, values) {
+      t.notOk(err, 'no error from nextBatch()')
+      t.deepEqual(keys, [ 'three', 'two' ], 'continues where next() left off')
+      it.end(done)
+    })
+  })
+})
+
+makeTest('test nextBatch() respects iterator limit', function (db, t, done) {
+  var it = db.iterator({ limit: 2, keyAsBuffer: false, valueAsBuffer: false })
+  it.nextBatch(function (err, keys, values) {
+    t.notOk(err, 'no error from nextBatch()')
+    t.deepEqual(keys, [ 'one', 'three' ], 'iterator limit applies')
+    it.end(done)
+  })
+})
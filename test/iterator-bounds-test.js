@@ -0,0 +1,64 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+    , rangeData  = require('./range-data')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(function (err) {
+    t.notOk(err, 'no error from open()')
+    rangeData.fill(db, t.end.bind(t))
+  })
+})
+
+function boundsTest (name, options, expected) {
+  test('test iterator ' + name, function (t) {
+    rangeData.keys(db, options, function (err, result) {
+      t.notOk(err, 'no error from iterator')
+      t.deepEqual(result, expected, 'correct keys')
+      t.end()
+    })
+  })
+}
+
+boundsTest('with end tighter than lt', { gt: 'k10', lt: 'k20', end: 'k13' }
+  , [ 'k11', 'k12', 'k13' ])
+boundsTest('with lt tighter than end', { gte: 'k10', lt: 'k13', end: 'k20' }
+  , [ 'k10', 'k11', 'k12' ])
+boundsTest('with lt equal to end', { gte: 'k10', lt: 'k13', end: 'k13' }
+  , [ 'k10', 'k11', 'k12' ])
+boundsTest('reversed with start and end', { reverse: true, start: 'k13', end: 'k11' }
+  , [ 'k13', 'k12', 'k11' ])
+boundsTest('reversed with gt tighter than end', { reverse: true, lte: 'k13', gt: 'k11', end: 'k05' }
+  , [ 'k13', 'k12' ])
+boundsTest('with a limit inside the range', { gte: 'k50', limit: 2 }
+  , [ 'k50', 'k51' ])
+boundsTest('reversed with a limit past the range', { reverse: true, lt: 'k02', limit: 5 }
+  , [ 'k01', 'k00' ])
+boundsTest('with bounds that are not keys', { gt: 'k41a', lte: 'k43a' }
+  , [ 'k42', 'k43' ])
+
+test('test next() after the end of the range', function (t) {
+  var iterator = db.iterator({ gte: 'k98', keyAsBuffer: false })
+  iterator.next(function (err, key) {
+    t.equal(key, 'k98', 'first key')
+    iterator.next(function (err, key) {
+      t.equal(key, 'k99', 'second key')
+      iterator.next(function (err, key) {
+        t.equal(key, undefined, 'end of range')
+        iterator.next(function (err, key) {
+          t.equal(key, undefined, 'still at the end of range')
+          iterator.end(t.end.bind(t))
+        })
+      })
+    })
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
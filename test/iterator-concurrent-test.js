@@ -0,0 +1,62 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+  , data = []
+
+for (var i = 0; i < 200; i++)
+  data.push({ type: 'put', key: 'key' + (1000 + i), value: 'value' + i })
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(function () {
+    db.batch(data, t.end.bind(t))
+  })
+})
+
+function scan (options, callback) {
+  var iterator = db.iterator(options)
+    , keys = []
+  function next () {
+    iterator.next(function (err, key) {
+      if (err)
+        return callback(err)
+      if (key === undefined)
+        return iterator.end(function (err) { callback(err, keys) })
+      keys.push(key)
+      // a get() between every step, on whatever thread is free
+      db.get('key1100', function (err) {
+        if (err)
+          return callback(err)
+        next()
+      })
+    })
+  }
+  next()
+}
+
+test('test concurrent iterators keep their own position', function (t) {
+  var expected = data.map(function (d) { return d.key })
+    , pending = 4
+
+  function done (reverse) {
+    return function (err, keys) {
+      t.notOk(err, 'no error from scan')
+      t.deepEqual(keys, reverse ? expected.slice().reverse() : expected, 'all keys in order')
+      if (--pending === 0)
+        t.end()
+    }
+  }
+
+  scan({ keyAsBuffer: false }, done(false))
+  scan({ keyAsBuffer: false, reverse: true }, done(true))
+  scan({ keyAsBuffer: false }, done(false))
+  scan({ keyAsBuffer: false, reverse: true }, done(true))
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
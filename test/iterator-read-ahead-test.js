@@ -0,0 +1,103 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+  , data = []
+
+for (var i = 0; i < 500; i++)
+  data.push({ type: 'put', key: 'key' + (1000 + i), value: 'value' + i })
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(function () {
+    db.batch(data, t.end.bind(t))
+  })
+})
+
+test('test next() with readAhead', function (t) {
+  var iterator = db.iterator({
+          readAhead: true
+        , readAheadEntries: 64
+        , keyAsBuffer: false
+        , valueAsBuffer: false
+      })
+    , idx = 0
+    , sync = true
+
+  function next () {
+    sync = true
+    iterator.next(function (err, key, value) {
+      t.notOk(sync, 'callback is asynchronous')
+      t.notOk(err, 'no error from next()')
+      if (key === undefined) {
+        t.equal(idx, data.length, 'all entries')
+        return iterator.end(t.end.bind(t))
+      }
+      t.equal(key, data[idx].key, 'correct key')
+      t.equal(value, data[idx].value, 'correct value')
+      idx++
+      next()
+    })
+    sync = false
+  }
+  next()
+})
+
+test('test nextBatch() with readAhead', function (t) {
+  var iterator = db.iterator({
+          readAhead: true
+        , readAheadBytes: 1024
+        , keyAsBuffer: false
+        , valueAsBuffer: false
+      })
+    , keys = []
+
+  function next () {
+    iterator.nextBatch({ limit: 100 }, function (err, batchKeys, batchValues) {
+      t.notOk(err, 'no error from nextBatch()')
+      t.ok(batchKeys.length <= 100, 'no more than limit')
+      if (batchKeys.length === 0) {
+        t.equal(keys.length, data.length, 'all entries')
+        t.equal(keys[250], data[250].key, 'in order')
+        return iterator.end(t.end.bind(t))
+      }
+      keys.push.apply(keys, batchKeys)
+      next()
+    })
+  }
+  next()
+})
+
+test('test readAhead honours limit and range', function (t) {
+  var iterator = db.iterator({
+          readAhead: true
+        , gte: 'key1100'
+        , limit: 10
+        , keyAsBuffer: false
+      })
+  iterator.nextBatch(function (err, keys) {
+    t.notOk(err, 'no error from nextBatch()')
+    t.equal(keys.length, 10, 'limited')
+    t.equal(keys[0], 'key1100', 'starts at gte')
+    iterator.end(t.end.bind(t))
+  })
+})
+
+test('test end() while reading ahead', function (t) {
+  var iterator = db.iterator({ readAhead: true })
+  iterator.next(function (err, key) {
+    t.notOk(err, 'no error from next()')
+    t.ok(key, 'got an entry')
+    iterator.end(function (err) {
+      t.notOk(err, 'no error from end()')
+      t.end()
+    })
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
@@ -0,0 +1,142 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db, audit, hot
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open(t.end.bind(t))
+})
+
+test('test namespace() argument errors', function (t) {
+  t.throws(db.namespace.bind(db), 'requires a name')
+  t.throws(db.namespace.bind(db, 'bad/name'), 'invalid name')
+  t.throws(db.namespace.bind(db, 'data'), 'reserved name')
+  t.throws(db.namespace.bind(db, 'missing', { createIfMissing: false }), 'does not exist')
+  t.end()
+})
+
+test('test namespaces keep their entries apart', function (t) {
+  audit = db.namespace('audit', { writeBufferSize: 1024 * 1024, blockSize: 16384 })
+  hot   = db.namespace('hot')
+  db.put('k', 'main', function (err) {
+    t.notOk(err, 'no error')
+    audit.put('k', 'audit', function (err) {
+      t.notOk(err, 'no error')
+      db.get('k', { asBuffer: false }, function (err, value) {
+        t.equal(value, 'main', 'database entry')
+        audit.get('k', { asBuffer: false }, function (err, value) {
+          t.equal(value, 'audit', 'namespace entry')
+          hot.get('k', function (err) {
+            t.ok(err && /NotFound/.test(err.message), 'not in another namespace')
+            t.end()
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test batch() spanning namespaces', function (t) {
+  var snapshot = db.snapshot()
+  db.batch([
+      { type: 'put', key: 'x', value: '1', namespace: hot }
+    , { type: 'put', key: 'y', value: '2', namespace: audit }
+    , { type: 'del', key: 'k', namespace: audit }
+    , { type: 'put', key: 'z', value: '3' }
+  ], function (err) {
+    t.notOk(err, 'no error')
+    hot.get('x', { asBuffer: false }, function (err, value) {
+      t.equal(value, '1', 'written to hot')
+      audit.get('k', function (err) {
+        t.ok(err && /NotFound/.test(err.message), 'deleted from audit')
+        audit.get('k', { snapshot: snapshot, asBuffer: false }, function (err, value) {
+          t.equal(value, 'audit', 'snapshot reads across namespaces')
+          snapshot.release()
+          db.batch([ { type: 'put', key: 'a', value: '1', namespace: {} } ], function (err) {
+            t.ok(err, 'not a namespace handle')
+            t.end()
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test iterator() on a namespace', function (t) {
+  var iterator = audit.iterator({ keyAsBuffer: false })
+    , keys     = []
+  function next () {
+    iterator.next(function (err, key) {
+      t.notOk(err, 'no error')
+      if (key === undefined)
+        return iterator.end(function () {
+          t.deepEqual(keys, [ 'y' ], 'only the namespace\'s keys')
+          t.end()
+        })
+      keys.push(key)
+      next()
+    })
+  }
+  next()
+})
+
+test('test close() fails while namespaces are open', function (t) {
+  db.close(function (err) {
+    t.ok(err && /namespaces/.test(err.message), 'namespaces must be closed first')
+    audit.get('y', { asBuffer: false }, function (err, value) {
+      t.equal(value, '2', 'namespace still open')
+      audit.close(function () {
+        db.close(function (err) {
+          t.ok(err, 'one namespace still open')
+          hot.close(function () {
+            db.close(function (err) {
+              t.notOk(err, 'no error once the namespaces are closed')
+              t.end()
+            })
+          })
+        })
+      })
+    })
+  })
+})
+
+test('test namespaces use the database\'s pools and group commit', function (t) {
+  db = leveldown(testCommon.location())
+  db.open({ writeThreads: 1, groupCommit: true }, function (err) {
+    t.notOk(err, 'no error')
+    hot = db.namespace('hot')
+    t.equal(hot.poolStats().write.threads, 1, 'the database\'s write pool')
+    var pending = 10
+    for (var i = 0; i < 10; i++) {
+      hot.put('g' + i, 'v' + i, function (err) {
+        t.notOk(err, 'no error')
+        if (--pending)
+          return
+        hot.get('g9', { asBuffer: false }, function (err, value) {
+          t.equal(value, 'v9', 'written')
+          // a put still waiting for its group commit is written by close()
+          hot.put('late', 'v', function (err) {
+            t.notOk(err, 'no error')
+          })
+          hot.close(function () {
+            hot = db.namespace('hot')
+            hot.get('late', { asBuffer: false }, function (err, value) {
+              t.equal(value, 'v', 'written before the namespace closed')
+              hot.close(function () {
+                db.close(t.end.bind(t))
+              })
+            })
+          })
+        })
+      })
+    }
+  })
+})
+
+test('tearDown', function (t) {
+  testCommon.tearDown(t)
+})
@@ -0,0 +1,32 @@
+// one hundred entries, 'k00' => 'v0' up to 'k99' => 'v99', for tests
+// of operations on key ranges
+function fill (db, callback) {
+  var ops = []
+  for (var i = 0; i < 100; i++)
+    ops.push({ type: 'put', key: 'k' + (i < 10 ? '0' : '') + i, value: 'v' + i })
+  db.batch(ops, callback)
+}
+
+// collects the keys, as Strings, of an iterator made with `options`
+function keys (db, options, callback) {
+  if (typeof options == 'function') {
+    callback = options
+    options = {}
+  }
+  options.keyAsBuffer = false
+  options.values = false
+  var iterator = db.iterator(options)
+    , result = []
+  function next () {
+    iterator.next(function (err, key) {
+      if (err || key === undefined)
+        return iterator.end(function () { callback(err, result) })
+      result.push(key)
+      next()
+    })
+  }
+  next()
+}
+
+module.exports.fill = fill
+module.exports.keys = keys
@@ -0,0 +1,95 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+test('setUp common', testCommon.setUp)
+
+function exercise (options) {
+  return function (t) {
+    var location = testCommon.location()
+      , db       = leveldown(location)
+    db.open(options, function (err) {
+      t.notOk(err, 'no error from open()')
+      var pending = 200
+      for (var i = 0; i < 100; i++) {
+        db.put('key' + i, 'value' + i, done)
+        db.get('nokey' + i, function (err) {
+          t.ok(err, 'error from get() on missing key')
+          done()
+        })
+      }
+      function done () {
+        if (--pending > 0)
+          return
+        db.get('key42', { asBuffer: false }, function (err, value) {
+          t.notOk(err, 'no error from get()')
+          t.equal(value, 'value42', 'correct value')
+          db.close(function (err) {
+            t.notOk(err, 'no error from close()')
+            leveldown.destroy(location, t.end.bind(t))
+          })
+        })
+      }
+    })
+  }
+}
+
+test('test operations with a small session cache'
+  , exercise({ sessionCacheSize: 2 }))
+
+test('test operations with the session cache disabled'
+  , exercise({ sessionCacheSize: 0 }))
+
+test('test open() with a zero sessionMax fails', function (t) {
+  var db = leveldown(testCommon.location())
+  db.open({ sessionMax: 0 }, function (err) {
+    t.ok(err, 'error from open()')
+    t.end()
+  })
+})
+
+test('test iterators beyond sessionMax fail rather than crash', function (t) {
+  var location = testCommon.location()
+    , db       = leveldown(location)
+  db.open({ sessionMax: 8 }, function (err) {
+    t.notOk(err, 'no error from open()')
+    db.put('key', 'value', function (err) {
+      t.notOk(err, 'no error from put()')
+      var iterators = []
+        , errors    = 0
+        , pending   = 40
+      for (var i = 0; i < 40; i++) {
+        var iterator = db.iterator()
+        iterators.push(iterator)
+        iterator.next(function (err) {
+          if (err) {
+            t.ok(/session/.test(err.message), 'error names the session limit')
+            errors++
+          }
+          if (--pending === 0)
+            finish()
+        })
+      }
+      function finish () {
+        t.ok(errors > 0, 'iterators beyond the limit report an error')
+        var ending = iterators.length
+        iterators.forEach(function (iterator) {
+          iterator.end(function () {
+            if (--ending > 0)
+              return
+            db.get('key', { asBuffer: false }, function (err, value) {
+              t.notOk(err, 'sessions are usable again once handed back')
+              t.equal(value, 'value', 'correct value')
+              db.close(function (err) {
+                t.notOk(err, 'no error from close()')
+                leveldown.destroy(location, t.end.bind(t))
+              })
+            })
+          })
+        })
+      }
+    })
+  })
+})
+
+test('tearDown', testCommon.tearDown)
@@ -0,0 +1,75 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var options = {
+        sharedCache        : 'test-pool'
+      , sharedCacheSize    : 64 * 1024 * 1024
+      , sharedCacheReserve : 16 * 1024 * 1024
+    }
+  , dbs = []
+
+test('setUp common', testCommon.setUp)
+
+test('test databases sharing a cache pool', function (t) {
+  var pending = 3
+  for (var i = 0; i < 3; i++) {
+    var db = leveldown(testCommon.location())
+    dbs.push(db)
+    db.open(options, function (err) {
+      t.notOk(err, 'no error from open()')
+      if (--pending === 0)
+        t.end()
+    })
+  }
+})
+
+test('test each database gets at least its reserve', function (t) {
+  dbs.forEach(function (db) {
+    var max = Number(db.getProperty('wiredtiger.cache.bytes-max'))
+    t.ok(max >= options.sharedCacheReserve, 'reserve is kept')
+    t.ok(max <= options.sharedCacheSize, 'within the pool')
+  })
+  t.end()
+})
+
+test('test open() beyond the pool size', function (t) {
+  // three reserves of 16MB leave 16MB of the 64MB pool, ask for more
+  var db = leveldown(testCommon.location())
+  db.open({
+      sharedCache        : options.sharedCache
+    , sharedCacheSize    : options.sharedCacheSize
+    , sharedCacheReserve : 20 * 1024 * 1024
+  }, function (err) {
+    t.ok(err, 'the reserve does not fit in the pool')
+    if (!err)
+      return db.close(t.end.bind(t))
+    t.end()
+  })
+})
+
+test('test open() with another pool', function (t) {
+  var db = leveldown(testCommon.location())
+  db.open({ sharedCache: 'another-pool' }, function (err) {
+    t.ok(err, 'one pool per process')
+    t.end()
+  })
+})
+
+test('test open() with an invalid pool name', function (t) {
+  var db = leveldown(testCommon.location())
+  db.open({ sharedCache: 'bad name' }, function (err) {
+    t.ok(err, 'errors')
+    t.end()
+  })
+})
+
+test('tearDown', function (t) {
+  var pending = dbs.length
+  dbs.forEach(function (db) {
+    db.close(function () {
+      if (--pending === 0)
+        testCommon.tearDown(t)
+    })
+  })
+})
@@ -0,0 +1,78 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  t.throws(db.snapshot.bind(db), 'snapshot() throws before open()')
+  db.open(function () {
+    db.batch([
+        { type: 'put', key: 'a', value: '1' }
+      , { type: 'put', key: 'b', value: '2' }
+    ], t.end.bind(t))
+  })
+})
+
+test('test get() and getMany() through a snapshot', function (t) {
+  var snapshot = db.snapshot()
+  db.batch([
+      { type: 'put', key: 'a', value: 'changed' }
+    , { type: 'put', key: 'c', value: '3' }
+    , { type: 'del', key: 'b' }
+  ], function (err) {
+    t.notOk(err, 'no error from batch()')
+    db.get('a', { snapshot: snapshot, asBuffer: false }, function (err, value) {
+      t.notOk(err, 'no error from get()')
+      t.equal(value, '1', 'old value')
+      db.get('a', { asBuffer: false }, function (err, value) {
+        t.equal(value, 'changed', 'new value without the snapshot')
+        db.getMany([ 'a', 'b', 'c' ], { snapshot: snapshot, asBuffer: false }, function (err, values) {
+          t.notOk(err, 'no error from getMany()')
+          t.deepEqual(values, [ '1', '2', undefined ], 'old values')
+          t.equal(db.getSync('b', { snapshot: snapshot, asBuffer: false }), '2', 'getSync()')
+          snapshot.release()
+          t.end()
+        })
+      })
+    })
+  })
+})
+
+test('test iterator through a snapshot', function (t) {
+  var snapshot = db.snapshot()
+    , iterator = db.iterator({ snapshot: snapshot, keyAsBuffer: false })
+    , keys = []
+
+  // release straight away, the iterator keeps it alive
+  snapshot.release()
+  db.put('d', '4', function (err) {
+    t.notOk(err, 'no error from put()')
+    iterator.nextBatch(function (err, batchKeys) {
+      t.notOk(err, 'no error from nextBatch()')
+      t.deepEqual(batchKeys, [ 'a', 'c' ], 'write after snapshot not seen')
+      iterator.end(t.end.bind(t))
+    })
+  })
+})
+
+test('test released snapshot', function (t) {
+  var snapshot = db.snapshot()
+  snapshot.release()
+  snapshot.release()
+  db.get('a', { snapshot: snapshot }, function (err) {
+    t.ok(err, 'error from get()')
+    t.ok(/released/.test(err.message), 'released error')
+    t.throws(db.iterator.bind(db, { snapshot: snapshot }), 'iterator() throws')
+    t.end()
+  })
+})
+
+test('tearDown', function (t) {
+  // left open, close() releases it
+  db.snapshot()
+  db.close(testCommon.tearDown.bind(null, t))
+})
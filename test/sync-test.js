@@ -0,0 +1,60 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  t.throws(db.getSync.bind(db, 'foo'), 'getSync() throws before open()')
+  db.open(t.end.bind(t))
+})
+
+test('test putSync() and getSync()', function (t) {
+  t.equal(db.putSync('foo', 'bar'), undefined, 'putSync() returns nothing')
+  t.equal(db.getSync('foo', { asBuffer: false }), 'bar', 'String value')
+  var value = db.getSync('foo')
+  t.ok(Buffer.isBuffer(value), 'Buffer by default')
+  t.equal(value.toString(), 'bar', 'Buffer value')
+  db.putSync(new Buffer('buf'), new Buffer('fer'), { sync: true })
+  t.equal(db.getSync('buf', { asBuffer: false }), 'fer', 'Buffer key and value')
+  t.end()
+})
+
+test('test getSync() on a missing key', function (t) {
+  t.equal(db.getSync('nokey'), undefined, 'undefined for missing key')
+  t.end()
+})
+
+test('test sync methods argument errors', function (t) {
+  t.throws(db.getSync.bind(db), 'getSync() requires a key')
+  t.throws(db.getSync.bind(db, null), 'getSync() null key')
+  t.throws(db.getSync.bind(db, ''), 'getSync() empty key')
+  t.throws(db.putSync.bind(db, 'foo'), 'putSync() requires a value')
+  t.throws(db.putSync.bind(db, 'foo', null), 'putSync() null value')
+  t.throws(db.batchSync.bind(db), 'batchSync() requires an array')
+  t.throws(db.batchSync.bind(db, [ { type: 'put', key: 'foo' } ]), 'batchSync() put requires a value')
+  t.end()
+})
+
+test('test batchSync()', function (t) {
+  db.batchSync([
+      { type: 'put', key: 'one', value: '1' }
+    , { type: 'put', key: 'two', value: '2' }
+    , { type: 'del', key: 'foo' }
+  ])
+  t.equal(db.getSync('one', { asBuffer: false }), '1', 'first put')
+  t.equal(db.getSync('two', { asBuffer: false }), '2', 'second put')
+  t.equal(db.getSync('foo'), undefined, 'deleted')
+  db.get('two', { asBuffer: false }, function (err, value) {
+    t.notOk(err, 'no error from get()')
+    t.equal(value, '2', 'visible to get()')
+    t.end()
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
@@ -0,0 +1,62 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('test open() with an unknown connection setting', function (t) {
+  var bad = leveldown(testCommon.location())
+  bad.open({ wiredtiger: { connection: 'no_such_setting=1' } }, function (err) {
+    t.ok(err, 'errors')
+    t.ok(/no_such_setting/.test(err.message), 'names the setting')
+    t.end()
+  })
+})
+
+test('test open() with an unknown table setting', function (t) {
+  var bad = leveldown(testCommon.location())
+  bad.open({ wiredtiger: { table: 'no_such_setting=1' } }, function (err) {
+    t.ok(err, 'errors')
+    t.ok(/no_such_setting/.test(err.message), 'names the setting')
+    t.end()
+  })
+})
+
+test('setUp db with settings passed through', function (t) {
+  db = leveldown(testCommon.location())
+  db.open({
+      wiredtiger: {
+          connection : 'eviction_target=70,eviction_trigger=90,checkpoint=(wait=60)'
+        , table      : 'lsm=(merge_max=10),prefix_compression=true'
+      }
+  }, t.end.bind(t))
+})
+
+test('test put() and get() with settings passed through', function (t) {
+  db.put('key', 'value', function (err) {
+    t.notOk(err, 'no error')
+    db.get('key', { asBuffer: false }, function (err, value) {
+      t.notOk(err, 'no error')
+      t.equal(value, 'value', 'read back')
+      t.end()
+    })
+  })
+})
+
+test('test namespace() with table settings passed through', function (t) {
+  t.throws(
+      db.namespace.bind(db, 'bad', { wiredtiger: { table: 'no_such_setting=1' } })
+    , 'unknown setting'
+  )
+  var ns = db.namespace('ns', { wiredtiger: { table: 'prefix_compression=false' } })
+  ns.put('key', 'value', function (err) {
+    t.notOk(err, 'no error')
+    ns.close(t.end.bind(t))
+  })
+})
+
+test('tearDown', function (t) {
+  db.close(testCommon.tearDown.bind(null, t))
+})
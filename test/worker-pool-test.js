@@ -0,0 +1,106 @@
+const test       = require('tap').test
+    , testCommon = require('abstract-leveldown/testCommon')
+    , leveldown  = require('../')
+
+var db
+
+test('setUp common', testCommon.setUp)
+
+test('setUp db', function (t) {
+  db = leveldown(testCommon.location())
+  db.open({ readThreads: 2, writeThreads: 1 }, t.end.bind(t))
+})
+
+test('test poolStats() reports the pool sizes', function (t) {
+  var stats = db.poolStats()
+  t.equal(stats.read.threads, 2, 'two read threads')
+  t.equal(stats.write.threads, 1, 'one write thread')
+  t.equal(stats.read.queued, 0, 'nothing queued')
+  t.equal(stats.write.active, 0, 'nothing active')
+  t.end()
+})
+
+test('test put(), get(), del() and batch() on the pools', function (t) {
+  var pending = 100
+  t.plan(pending * 2 + 3)
+  for (var i = 0; i < 100; i++) {
+    db.put('key' + i, 'value' + i, function (err) {
+      t.notOk(err, 'no error from put()')
+      if (--pending === 0) {
+        db.get('key42', { asBuffer: false }, function (err, value) {
+          t.notOk(err, 'no error from get()')
+          t.equal(value, 'value42', 'correct value')
+          db.batch([ { type: 'del', key: 'key42' } ], function (err) {
+            t.notOk(err, 'no error from batch()')
+          })
+        })
+      }
+    })
+  }
+  for (var j = 0; j < 100; j++) {
+    db.get('nokey' + j, function (err) {
+      t.ok(err, 'error from get() on missing key')
+    })
+  }
+})
+
+test('test iterator on the read pool', function (t) {
+  var iterator = db.iterator({ keyAsBuffer: false, valueAsBuffer: false })
+    , count = 0
+  function next () {
+    iterator.next(function (err, key) {
+      t.notOk(err, 'no error from next()')
+      if (key === undefined)
+        return iterator.end(function (err) {
+          t.notOk(err, 'no error from end()')
+          t.equal(count, 99, 'all entries')
+          t.end()
+        })
+      count++
+      next()
+    })
+  }
+  next()
+})
+
+test('test close() does not wait on the pools in the main thread', function (t) {
+  var location = testCommon.location()
+    , other    = leveldown(location)
+  other.open({ writeThreads: 1 }, function (err) {
+    t.notOk(err, 'no error from open()')
+    for (var i = 0; i < 20; i++) {
+      var ops = []
+      for (var j = 0; j < 1000; j++)
+        ops.push({ type: 'put', key: 'k' + i + '-' + j, value: 'value' })
+      other.batch(ops, { sync: true }, function (err) {
+        t.notOk(err, 'no error from batch()')
+      })
+    }
+    var start = Date.now()
+    other.close(function (err) {
+      t.notOk(err, 'no error from close()')
+      t.ok(blocked * 2 < Date.now() - start
+        , 'close() returned before the queued writes ran')
+      leveldown.destroy(location, t.end.bind(t))
+    })
+    var blocked = Date.now() - start
+  })
+})
+
+test('test close() with pending work on the pools', function (t) {
+  var pending = 10
+  for (var i = 0; i < 10; i++) {
+    db.put('late' + i, 'value', function (err) {
+      t.notOk(err, 'no error from put()')
+      pending--
+    })
+  }
+  db.close(function (err) {
+    t.notOk(err, 'no error from close()')
+    t.equal(pending, 0, 'queued writes were called back first')
+    var stats = db.poolStats()
+    t.equal(stats.read.threads, 0, 'read pool gone')
+    t.equal(stats.write.threads, 0, 'write pool gone')
+    testCommon.tearDown(t)
+  })
+})